@@ -3,9 +3,13 @@
 in vec3 position;
 in vec3 normal;
 in vec4 color;
+in mat4 model;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout(std140) uniform Camera
+{
+    mat4 projection;
+    mat4 view;
+};
 
 out vec4 fPosition;
 out vec4 fColor;
@@ -14,11 +18,11 @@ out vec3 fNormal;
 
 void main(void)
 {
-    fPosition = view * vec4(position,1.0);
+    fPosition = view * model * vec4(position,1.0);
     fLightPosition = view * vec4(0.0,0.0,1.0,1.0);
 
     fColor = color;
-    fNormal = vec3(view * vec4(normal,0.0));
+    fNormal = vec3(view * model * vec4(normal,0.0));
 
     gl_Position = projection * fPosition;
     /*gl_Position.x *= 1000.0f;*/
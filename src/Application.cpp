@@ -5,8 +5,10 @@
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include <chrono>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
 
 using namespace std;
 
@@ -30,9 +32,9 @@ Application::Application()
     throw std::runtime_error("Couldn't init GLFW");
   }
 
-  // setting the opengl version
+  // setting the opengl version, 3.3 for the instanced attributes (glVertexAttribDivisor)
   int major = 3;
-  int minor = 2;
+  int minor = 3;
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
@@ -66,8 +68,16 @@ Application::Application()
   glEnable(GL_DEPTH_TEST);  // enable depth-testing
   glDepthFunc(GL_LESS);  // depth-testing interprets a smaller value as "closer"
 
-  // vsync
-  // glfwSwapInterval(false);
+  // vsync, swapping blocks until the next refresh
+  glfwSwapInterval(1);
+}
+
+Application::~Application() {
+  // after the derived members, so GPU resources are released with a live context
+  glfwTerminate();
+
+  if (currentApplication == this)
+    currentApplication = NULL;
 }
 
 GLFWwindow* Application::getWindow() const {
@@ -99,7 +109,6 @@ void Application::run() {
     // compute new time and delta time
     float t = glfwGetTime();
     deltaTime = t - time;
-    if (deltaTime < h_step) continue;
     time = t;
 
     // detech window related changes
@@ -113,9 +122,12 @@ void Application::run() {
 
     // Pool and process events
     glfwPollEvents();
-  }
 
-  glfwTerminate();
+    // without vsync, sleep instead of spinning through frames
+    float frameTime = glfwGetTime() - time;
+    if (frameTime < minFrameTime)
+      std::this_thread::sleep_for(std::chrono::duration<float>(minFrameTime - frameTime));
+  }
 }
 
 void Application::detectWindowDimensionChange() {
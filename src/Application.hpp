@@ -17,6 +17,7 @@ struct GLFWwindow;
 class Application {
  public:
   Application();
+  virtual ~Application();
 
   static Application& getInstance();
 
@@ -52,6 +53,7 @@ protected:
   // Time:
   float time;
   float deltaTime;
+  static constexpr float minFrameTime = 1.0f / 240.0f;
 
   // Dimensions:
   int width;
@@ -1,9 +1,25 @@
 #include "CollisionManager.hpp"
 
+#include "Profiler.hpp"
+#include "broadphases/SweepAndPrune.hpp"
+#include "components/RigidBody.hpp"
+
+#include <chrono>
+
 // ------------------------------------------------------------------------------------------------
 CollisionManager::CollisionManager()
   : m_colliders(std::vector<Physical*>(0)),
-  m_cachedResults{ }
+  m_broadphase(std::make_unique<SweepAndPrune>()),
+  m_nextPhysicalId(1),
+  m_pairCache{ },
+  m_frame(0),
+  m_pairTasks(0),
+  m_sphereStates(0),
+  m_contacts(0),
+  m_sphereBatch(),
+  m_statistics{ 0, 0, 0, 0.0f, 0.0f },
+  m_threadPool(nullptr),
+  m_chunkContacts(0)
 {
 }
 
@@ -21,7 +37,10 @@ bool CollisionManager::addPhysical(Physical* physical)
     return false;
   }
 
+  physical->m_physicalId = m_nextPhysicalId++;
+
   m_colliders.push_back(physical);
+  m_broadphase->addPhysical(physical);
 
   return true;
 }
@@ -41,6 +60,19 @@ bool CollisionManager::removePhysical(Physical* physical)
   }
 
   m_colliders.erase(it);
+  m_broadphase->removePhysical(physical);
+
+  uint64_t id = physical->m_physicalId;
+  std::erase_if(m_pairCache, [&](const auto& entry)
+                {
+                  return (entry.first >> 32) == id || (entry.first & 0xFFFFFFFF) == id;
+                });
+  std::erase_if(m_sleepingPairTasks, [&](const PairTask& task)
+                {
+                  return task.target == physical || task.body == physical;
+                });
+
+  physical->m_physicalId = 0;
 
   return true;
 }
@@ -48,19 +80,285 @@ bool CollisionManager::removePhysical(Physical* physical)
 // ------------------------------------------------------------------------------------------------
 void CollisionManager::clearAll()
 {
+  for (Physical* physical : m_colliders)
+  {
+    physical->m_physicalId = 0;
+  }
+
   m_colliders.clear();
-  m_cachedResults.clear();
+  m_broadphase->clearAll();
+  m_pairCache.clear();
+  m_contacts.clear();
+  m_sleepingPairTasks.clear();
 }
 
 // ------------------------------------------------------------------------------------------------
-CollisionManager::ResultMap CollisionManager::computeAllCollisions()
+void CollisionManager::setBroadphase(std::unique_ptr<Broadphase> broadphase)
 {
-  m_cachedResults.clear();
+  if (broadphase == nullptr)
+  {
+    return;
+  }
 
-  for (const auto& physical : m_colliders)
+  m_broadphase = std::move(broadphase);
+  m_broadphase->clearAll();
+
+  for (Physical* physical : m_colliders)
   {
-    physical->computeCollision(this);
+    m_broadphase->addPhysical(physical);
   }
+}
+
+// ------------------------------------------------------------------------------------------------
+Broadphase* CollisionManager::getBroadphase() const
+{
+  return m_broadphase.get();
+}
+
+// ------------------------------------------------------------------------------------------------
+const CollisionManager::Contacts& CollisionManager::computeAllCollisions()
+{
+  PROFILE_SCOPE("CollisionManager::computeAllCollisions");
+
+  using Clock = std::chrono::steady_clock;
+  using Milliseconds = std::chrono::duration<float, std::milli>;
+
+  m_contacts.clear();
+  m_sphereBatch.clear();
+  m_sphereStates.clear();
+  m_sleepingPairTasks.clear();
+  updateWorldCaches();
+
+  ++m_frame;
+
+  auto start = Clock::now();
+  const Broadphase::Pairs& pairs = m_broadphase->computePairs();
+  auto broadphaseEnd = Clock::now();
+
+  constexpr Physical::ShapeType sphereType = CollisionUtils::shapeType<SphereCollider>();
+
+  // Narrowphase only on Broadphase overlapping pairs
+  // - states are resolved serially so tasks only ever write their own
+  m_pairTasks.clear();
+  size_t sleepingPairs = 0;
+  for (const auto& [target, body] : pairs)
+  {
+    CollisionUtils::PairState& state = getPairState(target, body);
+    state.frame = m_frame;
+
+    // Last manifold and impulse are kept for when the pair wakes up
+    if (isSleepingPair(target, body))
+    {
+      m_sleepingPairTasks.push_back(PairTask{ target, body, &state });
+      ++sleepingPairs;
+      continue;
+    }
+
+    state.manifold = std::nullopt;
+
+    if (target->getShapeType() == sphereType && body->getShapeType() == sphereType)
+    {
+      m_sphereBatch.addPair(static_cast<SphereCollider*>(target), static_cast<SphereCollider*>(body));
+      m_sphereStates.push_back(&state);
+      continue;
+    }
+
+    m_pairTasks.push_back(PairTask{ target, body, &state });
+  }
+
+  size_t taskCount = m_pairTasks.size();
+  if (m_threadPool == nullptr || taskCount < MinParallelPairs)
+  {
+    computePairTasks(0, taskCount, m_contacts);
+  }
+  else
+  {
+    // Contiguous chunks merged in order give the same contacts as the serial loop
+    size_t chunkCount = std::min(4 * m_threadPool->getThreadCount(), taskCount);
+    if (m_chunkContacts.size() < chunkCount)
+    {
+      m_chunkContacts.resize(chunkCount);
+    }
+
+    m_threadPool->run(chunkCount, [&](size_t chunk)
+                      {
+                        m_chunkContacts[chunk].clear();
+                        computePairTasks(chunk * taskCount / chunkCount, (chunk + 1) * taskCount / chunkCount,
+                                         m_chunkContacts[chunk]);
+                      });
+
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+      m_contacts.insert(m_contacts.end(), m_chunkContacts[chunk].begin(), m_chunkContacts[chunk].end());
+    }
+  }
+
+  // Sphere pairs are filtered in batch, manifolds are only built for overlaps
+  for (uint32_t index : m_sphereBatch.computeOverlaps())
+  {
+    auto [sphere1, sphere2] = m_sphereBatch.getPair(index);
+    CollisionUtils::PairState& state = *m_sphereStates[index];
+
+    CollisionResult res = CollisionUtils::internalCompute(sphere1, sphere2, state);
+    if (!res.has_value())
+    {
+      continue;
+    }
+
+    state.manifold = res;
+    m_contacts.push_back(Contact{ sphere1, sphere2, *res, &state });
+  }
+
+  // Pairs left by the Broadphase are evicted, separated ones lose their impulse
+  for (auto it = m_pairCache.begin(); it != m_pairCache.end();)
+  {
+    if (it->second.frame != m_frame)
+    {
+      it = m_pairCache.erase(it);
+      continue;
+    }
+
+    if (!it->second.manifold.has_value())
+    {
+      it->second.normalImpulse = 0.0f;
+      it->second.frictionImpulse = glm::vec3(0.0f);
+    }
+
+    ++it;
+  }
+
+  auto narrowphaseEnd = Clock::now();
+
+  m_statistics.pairs = pairs.size();
+  m_statistics.sleepingPairs = sleepingPairs;
+  m_statistics.contacts = m_contacts.size();
+  m_statistics.broadphaseTime = Milliseconds(broadphaseEnd - start).count();
+  m_statistics.narrowphaseTime = Milliseconds(narrowphaseEnd - broadphaseEnd).count();
+
+  return m_contacts;
+}
+
+// ------------------------------------------------------------------------------------------------
+const CollisionManager::Contacts& CollisionManager::computeWokenCollisions()
+{
+  PROFILE_SCOPE("CollisionManager::computeWokenCollisions");
+
+  m_wokenContacts.clear();
+
+  // Serial, a wake only ever reaches a few pairs
+  size_t kept = 0;
+  for (size_t index = 0; index < m_sleepingPairTasks.size(); ++index)
+  {
+    const PairTask& task = m_sleepingPairTasks[index];
+    if (isSleepingPair(task.target, task.body))
+    {
+      m_sleepingPairTasks[kept++] = task;
+      continue;
+    }
+
+    task.state->manifold = CollisionUtils::dispatch(task.target, task.body, *task.state);
+    if (!task.state->manifold.has_value())
+    {
+      task.state->normalImpulse = 0.0f;
+      task.state->frictionImpulse = glm::vec3(0.0f);
+      continue;
+    }
+
+    m_wokenContacts.push_back(Contact{ task.target, task.body, *task.state->manifold, task.state });
+  }
+  m_sleepingPairTasks.resize(kept);
+
+  m_contacts.insert(m_contacts.end(), m_wokenContacts.begin(), m_wokenContacts.end());
+
+  m_statistics.sleepingPairs = m_sleepingPairTasks.size();
+  m_statistics.contacts = m_contacts.size();
+
+  return m_wokenContacts;
+}
+
+// ------------------------------------------------------------------------------------------------
+const CollisionManager::Contacts& CollisionManager::getContacts() const
+{
+  return m_contacts;
+}
+
+// ------------------------------------------------------------------------------------------------
+const CollisionManager::Statistics& CollisionManager::getStatistics() const
+{
+  return m_statistics;
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionManager::setParallelNarrowphase(bool enabled)
+{
+  if (enabled == isParallelNarrowphase())
+  {
+    return;
+  }
+
+  m_threadPool = enabled ? std::make_unique<ThreadPool>() : nullptr;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool CollisionManager::isParallelNarrowphase() const
+{
+  return (m_threadPool != nullptr);
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionManager::computePairTasks(size_t begin, size_t end, Contacts& contacts)
+{
+  PROFILE_SCOPE("CollisionManager::computePairTasks");
+
+  for (size_t index = begin; index < end; ++index)
+  {
+    const PairTask& task = m_pairTasks[index];
+
+    CollisionResult res = CollisionUtils::dispatch(task.target, task.body, *task.state);
+    if (!res.has_value())
+    {
+      continue;
+    }
+
+    task.state->manifold = res;
+    contacts.push_back(Contact{ task.target, task.body, *res, task.state });
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+uint64_t CollisionManager::makePairId(const Physical* body1, const Physical* body2)
+{
+  return ((uint64_t) body1->m_physicalId << 32) | (uint64_t) body2->m_physicalId;
+}
+
+// ------------------------------------------------------------------------------------------------
+CollisionUtils::PairState& CollisionManager::getPairState(Physical* body1, Physical* body2)
+{
+  return m_pairCache[makePairId(body1, body2)];
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionManager::updateWorldCaches()
+{
+  for (Physical* physical : m_colliders)
+  {
+    physical->updateWorldCache();
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool CollisionManager::isSleepingPair(const Physical* body1, const Physical* body2)
+{
+  auto isSleeping = [](const Physical* physical)
+  {
+    return physical->hasBody() && physical->getRigidBody()->isSleeping();
+  };
+
+  // Static and kinematic bodies never wake a sleeping one
+  auto isResting = [&](const Physical* physical)
+  {
+    return !physical->hasBody() || physical->getRigidBody()->isKinematic() || isSleeping(physical);
+  };
 
-  return m_cachedResults;
+  return (isSleeping(body1) || isSleeping(body2)) && isResting(body1) && isResting(body2);
 }
@@ -4,13 +4,22 @@
 #include "components/BoxCollider.hpp"
 #include "components/SphereCollider.hpp"
 
+#include "SeparatingAxis.hpp"
+#include "SphereBatch.hpp"
+#include "ThreadPool.hpp"
+
+#include "broadphases/Broadphase.hpp"
+
 #include <algorithm>
 #include <vector>
 #include <numeric>
 #include <optional>
 #include <utility>
 #include <tuple>
+#include <unordered_map>
 #include <array>
+#include <bit>
+#include <type_traits>
 
 // ------------------------------------------------------------------------------------------------
 namespace CollisionUtils
@@ -18,6 +27,62 @@ namespace CollisionUtils
   template <typename T>
   concept PhysicalDerived = std::derived_from<T, Physical>;
 
+  template <PhysicalDerived ...Types>
+  struct TypeList
+  {
+    static constexpr size_t size = sizeof...(Types);
+  };
+
+  // List of all Physicals, their position is their ShapeType
+  using PhysicalTypes = TypeList<
+    BoxCollider,
+    SphereCollider
+    // TO COMPLETE
+  >;
+
+  template <PhysicalDerived T, PhysicalDerived ...Types>
+  constexpr Physical::ShapeType indexOf(TypeList<Types...>)
+  {
+    constexpr std::array<bool, sizeof...(Types)> matches = { std::is_same_v<T, Types>... };
+
+    Physical::ShapeType index = 0;
+    while (index < matches.size() && !matches[index])
+    {
+      ++index;
+    }
+
+    return index;
+  }
+
+  template <PhysicalDerived T>
+  constexpr Physical::ShapeType shapeType()
+  {
+    constexpr Physical::ShapeType index = indexOf<T>(PhysicalTypes{});
+    static_assert(index < PhysicalTypes::size, "Physical is missing from PhysicalTypes");
+
+    return index;
+  }
+
+  // Narrowphase data kept from one step to the next for a pair of Physicals
+  // - directions follow the bodies order given to internalCompute
+  struct PairState
+  {
+    // Last Separating Axis of an OBB pair, 0 when never separated
+    // 15 ------- 7 - 6 -------- 1 - 0
+    // 9 Edges Axis - 6 Faces Axis - 1
+    std::array<uint16_t, 2> separatingAxis = { 0, 0 };
+
+    // Last contact, if the pair was colliding
+    CollisionResult manifold = std::nullopt;
+
+    // Accumulated impulses of the last solve, warm start the next one
+    float normalImpulse = 0.0f;
+    glm::vec3 frictionImpulse = glm::vec3(0.0f);
+
+    // Last step the pair was a Broadphase candidate
+    uint64_t frame = 0;
+  };
+
   // Utility Methods ------------------------------------------------------------------------------
   inline CollisionResult swap(const CollisionResult& res)
   {
@@ -35,46 +100,17 @@ namespace CollisionUtils
   }
 
   template <PhysicalDerived T1, PhysicalDerived T2>
-  inline CollisionResult internalCompute(T1* body1, T2* body2)
+  inline CollisionResult internalCompute(T1* body1, T2* body2, PairState& state)
   {
     return std::nullopt;
   }
 
   template <PhysicalDerived T1, PhysicalDerived T2>
-  inline CollisionResult compute(T1* body1, T2* body2)
+  inline CollisionResult compute(T1* body1, T2* body2, PairState& state)
   {
     return (priority<T1>() > priority<T2>())
-      ? swap(internalCompute(body2, body1))
-      : internalCompute(body1, body2);
-  }
-
-  // Variadic Casting -----------------------------------------------------------------------------
-  template <PhysicalDerived TTarget>
-  inline CollisionResult physicalCastCompute(TTarget*, Physical*)
-  {
-    return std::nullopt;
-  }
-
-  template <PhysicalDerived TTarget, PhysicalDerived TBody, PhysicalDerived ...Types>
-  inline CollisionResult physicalCastCompute(TTarget* target, Physical* body)
-  {
-    auto result = dynamic_cast<TBody*>(body);
-    return (result == nullptr)
-      ? physicalCastCompute<TTarget, Types...>(target, body)
-      : compute<TTarget, TBody>(target, result);
-  }
-
-  template <PhysicalDerived T>
-  inline CollisionResult concreteCompute(T* target, Physical* body)
-  {
-    return physicalCastCompute<T,
-
-      // List of all Physicals
-      BoxCollider,
-      SphereCollider
-      // TO COMPLETE
-
-    >(target, body);
+      ? swap(internalCompute(body2, body1, state))
+      : internalCompute(body1, body2, state);
   }
 
   // Box Definitions ------------------------------------------------------------------------------
@@ -85,28 +121,12 @@ namespace CollisionUtils
   }
 
   template <>
-  inline CollisionResult internalCompute<BoxCollider, BoxCollider>(BoxCollider* body1, BoxCollider* body2)
+  inline CollisionResult internalCompute<BoxCollider, BoxCollider>(BoxCollider* body1, BoxCollider* body2, PairState& state)
   {
-    auto computeA2B = [](BoxCollider* bodyA, BoxCollider* bodyB) -> std::optional<CollisionBodyData>
+    auto computeA2B = [](BoxCollider* bodyA, BoxCollider* bodyB, uint16_t& separatingAxis) -> std::optional<CollisionBodyData>
     {
-      using Vertices = std::vector<glm::vec3>; // Set of 8 Vertices (for OBBs)
-      using Interval = std::pair<float, float>; // First: Lower, Second: Upper
-
-      // Interval of each Vertices Projection
-      auto projInterval = [](const glm::vec3& axis, const Vertices& V) -> Interval
-      {
-        float proj = glm::dot(axis, V[0]);
-        Interval result = std::make_pair(proj, proj);
-
-        for (size_t ii = 1; ii < V.size(); ++ii)
-        {
-          proj = glm::dot(axis, V[ii]);
-          if (proj > result.second) result.second = proj;
-          else if (proj < result.first) result.first = proj;
-        }
-
-        return result;
-      };
+      using Vertices = SeparatingAxis::Corners; // Set of 8 Vertices (for OBBs)
+      using Interval = SeparatingAxis::Interval; // First: Lower, Second: Upper
 
       // Is Overlapping on the specified Axis
       auto isOverlapping = [&](const glm::vec3& axis,
@@ -115,8 +135,8 @@ namespace CollisionUtils
                                float& s,
                                float& overlap) -> bool
       {
-        Interval iA = projInterval(axis, A);
-        Interval iB = projInterval(axis, B);
+        Interval iA = SeparatingAxis::project(axis, A);
+        Interval iB = SeparatingAxis::project(axis, B);
 
         if (iA.first >= iB.first)
         {
@@ -161,33 +181,21 @@ namespace CollisionUtils
         return glm::vec3(M[i]);
       };
 
-      // Convert to Vertices
-      auto getVertices = [](BoxCollider* body, const glm::mat4& localToWorld) -> Vertices
-      {
-        Vertices result(0);
-        auto vertices = body->getVertices();
-
-        std::transform(vertices.begin(), vertices.end(), std::back_inserter(result),
-                       [&](VertexType vtx) -> glm::vec3
-                       {
-                         return localToWorld * glm::vec4(vtx.position, 1.0);
-                       });
-
-        return result;
-      };
+      // Initialize Values (cached once per step)
+      const BoxCollider::WorldOBB& obbA = bodyA->getWorldOBB();
+      const BoxCollider::WorldOBB& obbB = bodyB->getWorldOBB();
 
-      // Initialize Values
-      glm::mat4 A = bodyA->localToWorld();
-      glm::mat4 B = bodyB->localToWorld();
+      const glm::mat4& A = obbA.transform;
+      const glm::mat4& B = obbB.transform;
       //glm::mat3 C = glm::transpose(glm::transpose(glm::mat3(A)) * glm::mat3(B));
       glm::mat3 C = glm::transpose(glm::mat3(A)) * glm::mat3(B);
       glm::vec3 D = col(B, 3) - col(A, 3);
-      glm::vec3 a = bodyA->getScale() * 0.5f;
-      glm::vec3 b = bodyB->getScale() * 0.5f;
+      const glm::vec3& a = obbA.halfExtents;
+      const glm::vec3& b = obbB.halfExtents;
 
       // Initialize Vertices
-      Vertices A_vertices = getVertices(bodyA, A);
-      Vertices B_vertices = getVertices(bodyB, B);
+      const Vertices& A_vertices = obbA.corners;
+      const Vertices& B_vertices = obbB.corners;
 
       std::array<float, 15> sigmas, overlaps;
       float sigma, overlap;
@@ -195,44 +203,70 @@ namespace CollisionUtils
       uint16_t sat_result = 1;
       size_t sat_index = 0;
 
-      auto bindNext = [&](bool r)
+      // Axis of each SAT flag
+      // - 1 to 6: Face Axis, 7 to 15: Edge Axis
+      auto getAxis = [&](size_t flag) -> glm::vec3
       {
+        if (flag <= 3) return -col(A, flag - 1);
+        if (flag <= 6) return col(B, flag - 4);
+
+        return glm::cross(col(A, (flag - 7) / 3), col(B, (flag - 7) % 3));
+      };
+
+      // Returns true on the first Separating Axis
+      auto bindNext = [&](const glm::vec3& axis) -> bool
+      {
+        bool r = isOverlapping(axis, A_vertices, B_vertices, sigma, overlap);
+
         sigmas[sat_index] = sigma;
         overlaps[sat_index] = overlap;
 
         if (r) sat_result |= (1 << (++sat_index));
         else sat_index++;
+
+        return !r;
       };
 
-      // Face Axis
-      for (size_t i = 0; i < 3; ++i)
-      {
-        bindNext(isOverlapping(-col(A, i), A_vertices, B_vertices, sigma, overlap));
-      }
-      for (size_t j = 0; j < 3; ++j)
+      // No Intersection
+      // - only the first separating axis is read back, the following ones are left unset
+      auto saveSAT = [&]() -> std::optional<CollisionBodyData>
       {
-        bindNext(isOverlapping(col(B, j), A_vertices, B_vertices, sigma, overlap));
-      }
+        sat_result |= (uint16_t) (0xFFFF << (sat_index + 1));
+        separatingAxis = sat_result;
 
-      // Edge Axis
-      for (size_t i = 0; i < 3; ++i)
+        return std::nullopt;
+      };
+
+      // Frame-to-frame coherence: the last separating axis most likely still separates
+      if (separatingAxis != 0)
       {
-        for (size_t j = 0; j < 3; ++j)
+        size_t flag = std::countr_zero((uint16_t) ~separatingAxis);
+        if (flag <= 15 && !isOverlapping(getAxis(flag), A_vertices, B_vertices, sigma, overlap))
         {
-          bindNext(isOverlapping(glm::cross(col(A, i), col(B, j)), A_vertices, B_vertices, sigma, overlap));
+          return std::nullopt;
         }
       }
 
-      // Finding Previous SAT
-      uint16_t prev_sat_result = bodyA->OBBSeparatingAxis.contains(bodyB) ? bodyA->OBBSeparatingAxis[bodyB] : 0;
-
-      // No Intersection
-      if (sat_result != (uint16_t) ~0)
+      for (size_t flag = 1; flag <= 15; ++flag)
       {
-        // Saving SAT
-        bodyA->OBBSeparatingAxis[bodyB] = sat_result;
+        if (bindNext(getAxis(flag))) return saveSAT();
+      }
 
-        return std::nullopt;
+      // Finding Previous SAT
+      // - pairs never tested apart (culled by the Broadphase) fall back on the least penetrating face
+      uint16_t prev_sat_result = (uint16_t) ~0;
+      if (separatingAxis != 0)
+      {
+        prev_sat_result = separatingAxis;
+      }
+      else
+      {
+        size_t face = 0;
+        for (size_t ii = 1; ii < 6; ++ii)
+        {
+          if (overlaps[ii] < overlaps[face]) face = ii;
+        }
+        prev_sat_result ^= (1 << (face + 1));
       }
 
       glm::vec3 pos;
@@ -340,8 +374,6 @@ namespace CollisionUtils
       // Error
       else return std::nullopt;
 
-      if (flag > 6) std::cout << "Flag: " << flag << std::endl; //DEBUG
-
       // Sends out result
       return CollisionBodyData
       {
@@ -351,11 +383,10 @@ namespace CollisionUtils
       };
     };
 
-    auto resultAB = computeA2B(body1, body2);
-    if (!resultAB.has_value()) return std::nullopt;
-
-    auto resultBA = computeA2B(body2, body1);
-    if (!resultBA.has_value()) return std::nullopt;
+    // Both directions are evaluated so each body keeps its own separating axis history
+    auto resultAB = computeA2B(body1, body2, state.separatingAxis[0]);
+    auto resultBA = computeA2B(body2, body1, state.separatingAxis[1]);
+    if (!resultAB.has_value() || !resultBA.has_value()) return std::nullopt;
 
     return std::make_pair(*resultAB, *resultBA);
   }
@@ -368,26 +399,27 @@ namespace CollisionUtils
   }
 
   template <>
-  inline CollisionResult internalCompute<SphereCollider, SphereCollider>(SphereCollider* sphere1, SphereCollider* sphere2)
+  inline CollisionResult internalCompute<SphereCollider, SphereCollider>(SphereCollider* sphere1, SphereCollider* sphere2, PairState&)
   {
     const float radiusSphere1 = sphere1->getRadius();
     const float radiusSphere2 = sphere2->getRadius();
 
-    const glm::mat4 localToWorldSphere1 = sphere1->localToWorld();
-    const glm::mat4 localToWorldSphere2 = sphere2->localToWorld();
-
-    const glm::vec3 centerSphere1 = localToWorldSphere1[3];
-    const glm::vec3 centerSphere2 = localToWorldSphere2[3];
+    const glm::vec3& centerSphere1 = sphere1->getWorldCenter();
+    const glm::vec3& centerSphere2 = sphere2->getWorldCenter();
 
-    float distBetweenCenters = glm::length(centerSphere2 - centerSphere1);
+    glm::vec3 offset = centerSphere2 - centerSphere1;
+    float sqrDistBetweenCenters = glm::dot(offset, offset);
     float radiusesSum = radiusSphere1 + radiusSphere2;
 
-    if (distBetweenCenters > radiusesSum)
+    // Same test as SphereBatch lanes
+    if (sqrDistBetweenCenters > radiusesSum * radiusesSum)
     {
       return std::nullopt;
-    } 
+    }
+
+    float distBetweenCenters = glm::sqrt(sqrDistBetweenCenters);
 
-    glm::vec3 normal = glm::normalize(centerSphere2 - centerSphere1);
+    glm::vec3 normal = offset / distBetweenCenters;
     glm::vec3 pos1 = centerSphere1 + (radiusSphere1 / distBetweenCenters) * (centerSphere2 - centerSphere1);
     glm::vec3 pos2 = centerSphere2 + (radiusSphere2 / distBetweenCenters) * (centerSphere1 - centerSphere2);
     glm::vec3 pos = (pos1 + pos2) * 0.5f;
@@ -407,15 +439,15 @@ namespace CollisionUtils
 
   // Physical Intersections -----------------------------------------------------------------------
   template <>
-  inline CollisionResult internalCompute<BoxCollider, SphereCollider>(BoxCollider* box, SphereCollider* sphere)
+  inline CollisionResult internalCompute<BoxCollider, SphereCollider>(BoxCollider* box, SphereCollider* sphere, PairState&)
   {
-    glm::mat4 sphereL2W = sphere->localToWorld();
-    glm::vec3 sphereCenter = sphereL2W[3];
+    const BoxCollider::WorldOBB& obb = box->getWorldOBB();
+    const glm::vec3& sphereCenter = sphere->getWorldCenter();
 
-    glm::mat4 boxL2W = box->localToWorld();
-    glm::vec3 sphereCenterInBox = glm::inverse(boxL2W) * glm::vec4(sphereCenter, 1.0);
+    const glm::mat4& boxL2W = obb.transform;
+    glm::vec3 sphereCenterInBox = obb.inverse * glm::vec4(sphereCenter, 1.0);
 
-    glm::vec3 boxHalfScale = box->getScale() * 0.5f;
+    const glm::vec3& boxHalfScale = obb.halfExtents;
     glm::vec3 projection = glm::clamp(sphereCenterInBox, -boxHalfScale, boxHalfScale);
 
     glm::vec3 contactPoint = boxL2W * glm::vec4(projection, 1.0);
@@ -439,6 +471,38 @@ namespace CollisionUtils
         contactPoint, -normal, penetration
       });
   }
+
+  // Dispatch Table -------------------------------------------------------------------------------
+  // Must follow every internalCompute specialization
+  using DispatchFunction = CollisionResult (*)(Physical*, Physical*, PairState&);
+
+  template <PhysicalDerived T1, PhysicalDerived T2>
+  inline CollisionResult dispatchCompute(Physical* body1, Physical* body2, PairState& state)
+  {
+    return compute<T1, T2>(static_cast<T1*>(body1), static_cast<T2*>(body2), state);
+  }
+
+  template <PhysicalDerived T, PhysicalDerived ...Types>
+  constexpr std::array<DispatchFunction, sizeof...(Types)> makeDispatchRow()
+  {
+    return { &dispatchCompute<T, Types>... };
+  }
+
+  template <PhysicalDerived ...Types>
+  constexpr auto makeDispatchTable(TypeList<Types...>)
+  {
+    return std::array<std::array<DispatchFunction, sizeof...(Types)>, sizeof...(Types)>
+    {
+      makeDispatchRow<Types, Types...>()...
+    };
+  }
+
+  inline constexpr auto DispatchTable = makeDispatchTable(PhysicalTypes{});
+
+  inline CollisionResult dispatch(Physical* body1, Physical* body2, PairState& state)
+  {
+    return DispatchTable[body1->getShapeType()][body2->getShapeType()](body1, body2, state);
+  }
 }
 
 
@@ -446,8 +510,33 @@ namespace CollisionUtils
 class CollisionManager final
 {
 public:
-  using Result = std::map<Physical*, CollisionManifold>;
-  using ResultMap = std::map<Physical*, Result>;
+  // Each colliding pair is stored once, manifold.first belongs to bodyA
+  struct Contact
+  {
+    Physical* bodyA;
+    Physical* bodyB;
+    CollisionManifold manifold;
+    CollisionUtils::PairState* state; // Valid until the next computeAllCollisions
+  };
+  using Contacts = std::vector<Contact>;
+
+  // Narrowphase pair with its persistent state
+  struct PairTask
+  {
+    Physical* target;
+    Physical* body;
+    CollisionUtils::PairState* state;
+  };
+
+  // Last computeAllCollisions, times in milliseconds
+  struct Statistics
+  {
+    size_t pairs;
+    size_t sleepingPairs;
+    size_t contacts;
+    float broadphaseTime;
+    float narrowphaseTime;
+  };
 
 public:
   CollisionManager();
@@ -456,46 +545,55 @@ public:
   bool removePhysical(Physical* physical);
   void clearAll();
 
-  template <CollisionUtils::PhysicalDerived T>
-  Result computeTargetCollisions(T* target);
+  // Registered Physicals are carried over to the new Broadphase
+  void setBroadphase(std::unique_ptr<Broadphase> broadphase);
+  Broadphase* getBroadphase() const;
 
-  ResultMap computeAllCollisions();
+  // Buffer is reused from one call to the next
+  const Contacts& computeAllCollisions();
+  const Contacts& getContacts() const;
 
-private:
-  std::vector<Physical*> m_colliders;
-  ResultMap m_cachedResults;
-};
+  // Tests the pairs skipped as sleeping by the last computeAllCollisions that a woken body made active
+  // - their contacts are returned, and added to the ones of the step
+  const Contacts& computeWokenCollisions();
 
-// ------------------------------------------------------------------------------------------------
-template<CollisionUtils::PhysicalDerived T>
-inline CollisionManager::Result CollisionManager::computeTargetCollisions(T* target)
-{
-  Result result;
+  const Statistics& getStatistics() const;
 
-  for (Physical* physical : m_colliders)
-  {
-    if (physical == target)
-    {
-      continue;
-    }
+  // Pair tests are spread over a ThreadPool, contacts keep the serial order
+  void setParallelNarrowphase(bool enabled);
+  bool isParallelNarrowphase() const;
 
-    if (m_cachedResults[physical].contains(target))
-    {
-      result[physical] = *CollisionUtils::swap(m_cachedResults[physical][target]);
-      continue;
-    }
+private:
+  // Below this amount of pairs, threads cost more than they save
+  static constexpr size_t MinParallelPairs = 64;
 
-    CollisionResult res = CollisionUtils::concreteCompute(target, physical);
-    if (!res.has_value())
-    {
-      continue;
-    }
+  // Ordered pair of Physical ids, stable while both stay registered
+  static uint64_t makePairId(const Physical* body1, const Physical* body2);
+  CollisionUtils::PairState& getPairState(Physical* body1, Physical* body2);
 
-    result[physical] = *res;
-  }
+  // Pairs of a sleeping body and a body that cannot move it are not tested
+  static bool isSleepingPair(const Physical* body1, const Physical* body2);
 
-  // Cache results to prevent recomputation
-  m_cachedResults[target] = result;
+  void updateWorldCaches();
+  void computePairTasks(size_t begin, size_t end, Contacts& contacts);
 
-  return result;
-}
+private:
+  std::vector<Physical*> m_colliders;
+  std::unique_ptr<Broadphase> m_broadphase;
+  uint32_t m_nextPhysicalId;
+
+  // Entries not reported by the Broadphase during a step are evicted
+  std::unordered_map<uint64_t, CollisionUtils::PairState> m_pairCache;
+  uint64_t m_frame;
+
+  std::vector<PairTask> m_pairTasks;
+  std::vector<PairTask> m_sleepingPairTasks;
+  Contacts m_wokenContacts;
+  std::vector<CollisionUtils::PairState*> m_sphereStates;
+  Contacts m_contacts;
+  SphereBatch m_sphereBatch;
+  Statistics m_statistics;
+
+  std::unique_ptr<ThreadPool> m_threadPool;
+  std::vector<Contacts> m_chunkContacts;
+};
@@ -0,0 +1,171 @@
+#include "FrustumCuller.hpp"
+
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FRUSTUM_CULLER_SSE
+#endif
+
+// ------------------------------------------------------------------------------------------------
+FrustumCuller::FrustumCuller()
+  : m_planes(), m_centersX(0), m_centersY(0), m_centersZ(0), m_radiuses(0), m_visibility(0), m_stats{ 0, 0 }
+{
+  // Nothing culled until a frustum is set
+  m_planes.fill(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+// ------------------------------------------------------------------------------------------------
+void FrustumCuller::setFrustum(const glm::mat4& viewProjection)
+{
+  // Gribb/Hartmann: clip space bounds are combinations of the matrix rows
+  glm::vec4 rows[4];
+  for (int row = 0; row < 4; ++row)
+  {
+    rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+  }
+
+  m_planes = { rows[3] + rows[0], rows[3] - rows[0],
+               rows[3] + rows[1], rows[3] - rows[1],
+               rows[3] + rows[2], rows[3] - rows[2] };
+
+  for (glm::vec4& plane : m_planes)
+  {
+    plane = plane * (1.0f / glm::length(glm::vec3(plane)));
+  }
+
+  m_stats = Stats{ 0, 0 };
+}
+
+// ------------------------------------------------------------------------------------------------
+void FrustumCuller::clear()
+{
+  m_centersX.clear();
+  m_centersY.clear();
+  m_centersZ.clear();
+  m_radiuses.clear();
+
+  m_visibility.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+void FrustumCuller::add(const BoundingSphere& localBounds, const glm::mat4& localToWorld)
+{
+  // Never culled if unbounded
+  BoundingSphere bounds = localBounds.toWorld(localToWorld);
+  float radius = bounds.radius >= 0.0f ? bounds.radius : std::numeric_limits<float>::infinity();
+
+  m_centersX.push_back(bounds.center.x);
+  m_centersY.push_back(bounds.center.y);
+  m_centersZ.push_back(bounds.center.z);
+  m_radiuses.push_back(radius);
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t FrustumCuller::size() const
+{
+  return m_radiuses.size();
+}
+
+// ------------------------------------------------------------------------------------------------
+const std::vector<uint8_t>& FrustumCuller::computeVisibility()
+{
+  const size_t size = m_radiuses.size();
+  m_visibility.assign(size, 1);
+
+  size_t index = 0;
+
+  // Signed distances below -radius are behind a plane
+#if defined(__AVX__)
+  for (; index + 8 <= size; index += 8)
+  {
+    __m256 x = _mm256_loadu_ps(m_centersX.data() + index);
+    __m256 y = _mm256_loadu_ps(m_centersY.data() + index);
+    __m256 z = _mm256_loadu_ps(m_centersZ.data() + index);
+    __m256 r = _mm256_loadu_ps(m_radiuses.data() + index);
+    __m256 minusR = _mm256_sub_ps(_mm256_setzero_ps(), r);
+
+    __m256 outside = _mm256_setzero_ps();
+    for (const glm::vec4& plane : m_planes)
+    {
+      __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane.x)),
+                                                    _mm256_mul_ps(y, _mm256_set1_ps(plane.y))),
+                                      _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(plane.z)),
+                                                    _mm256_set1_ps(plane.w)));
+      outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, minusR, _CMP_LT_OQ));
+    }
+
+    int mask = _mm256_movemask_ps(outside);
+    for (int lane = 0; lane < 8; ++lane)
+    {
+      if ((mask & (1 << lane)) != 0) m_visibility[index + lane] = 0;
+    }
+  }
+#elif defined(FRUSTUM_CULLER_SSE)
+  for (; index + 4 <= size; index += 4)
+  {
+    __m128 x = _mm_loadu_ps(m_centersX.data() + index);
+    __m128 y = _mm_loadu_ps(m_centersY.data() + index);
+    __m128 z = _mm_loadu_ps(m_centersZ.data() + index);
+    __m128 r = _mm_loadu_ps(m_radiuses.data() + index);
+    __m128 minusR = _mm_sub_ps(_mm_setzero_ps(), r);
+
+    __m128 outside = _mm_setzero_ps();
+    for (const glm::vec4& plane : m_planes)
+    {
+      __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)),
+                                              _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+                                   _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)),
+                                              _mm_set1_ps(plane.w)));
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, minusR));
+    }
+
+    int mask = _mm_movemask_ps(outside);
+    for (int lane = 0; lane < 4; ++lane)
+    {
+      if ((mask & (1 << lane)) != 0) m_visibility[index + lane] = 0;
+    }
+  }
+#endif
+
+  // Remaining lanes
+  for (; index < size; ++index)
+  {
+    if (!isVisible(index)) m_visibility[index] = 0;
+  }
+
+  m_stats.tested += size;
+  for (uint8_t visible : m_visibility)
+  {
+    m_stats.culled += (visible == 0);
+  }
+
+  return m_visibility;
+}
+
+// ------------------------------------------------------------------------------------------------
+const FrustumCuller::Stats& FrustumCuller::getStats() const
+{
+  return m_stats;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool FrustumCuller::isVisible(size_t index) const
+{
+  float x = m_centersX[index];
+  float y = m_centersY[index];
+  float z = m_centersZ[index];
+  float r = m_radiuses[index];
+
+  for (const glm::vec4& plane : m_planes)
+  {
+    if (plane.x * x + plane.y * y + plane.z * z + plane.w < -r)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
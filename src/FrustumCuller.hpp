@@ -0,0 +1,55 @@
+#pragma once
+
+#include "StructInfo.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// View frustum test of World bounding spheres:
+// * spheres are packed per coordinate, several of them tested per SIMD register
+// * a sphere is culled once it lies entirely behind one of the six planes
+// * counts are kept from setFrustum to the next one, for the statistics
+class FrustumCuller final
+{
+public:
+  struct Stats
+  {
+    size_t tested;
+    size_t culled;
+  };
+
+public:
+  FrustumCuller();
+
+  // Planes of a projection * view matrix, resets the statistics
+  void setFrustum(const glm::mat4& viewProjection);
+
+  // Buffers keep their capacity from one batch to the next
+  void clear();
+  void add(const BoundingSphere& localBounds, const glm::mat4& localToWorld);
+
+  size_t size() const;
+
+  // Per added sphere, in insertion order: 1 if visible, 0 if culled
+  const std::vector<uint8_t>& computeVisibility();
+
+  const Stats& getStats() const;
+
+private:
+  bool isVisible(size_t index) const;
+
+private:
+  // Normalized, normals pointing inside
+  std::array<glm::vec4, 6> m_planes;
+
+  std::vector<float> m_centersX;
+  std::vector<float> m_centersY;
+  std::vector<float> m_centersZ;
+  std::vector<float> m_radiuses;
+
+  std::vector<uint8_t> m_visibility;
+
+  Stats m_stats;
+};
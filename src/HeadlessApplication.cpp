@@ -0,0 +1,113 @@
+#include "HeadlessApplication.hpp"
+
+#include "Profiler.hpp"
+
+#include "scenes/BowlingScene.hpp"
+#include "scenes/BowlsScene.hpp"
+#include "scenes/PoolScene.hpp"
+#include "scenes/BallpitScene.hpp"
+#include "scenes/SpinningBatScene.hpp"
+#include "scenes/DominoScene.hpp"
+#include "scenes/DynamicScene.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+// ------------------------------------------------------------------------------------------------
+HeadlessApplication::HeadlessApplication()
+  : m_renderer(std::make_unique<Renderer>(nullptr)), m_steps(0), m_scenes(0)
+{
+  // Same scenes as MainApplication
+  m_scenes.push_back(std::make_unique<BowlingScene>());
+  m_scenes.push_back(std::make_unique<BowlsScene>());
+  m_scenes.push_back(std::make_unique<PoolScene>());
+  m_scenes.push_back(std::make_unique<BallpitScene>());
+  m_scenes.push_back(std::make_unique<SpinningBatScene>());
+  m_scenes.push_back(std::make_unique<DominoScene>());
+  m_scenes.push_back(std::make_unique<DynamicScene>());
+}
+
+// ------------------------------------------------------------------------------------------------
+const std::vector<std::unique_ptr<Scene>>& HeadlessApplication::getScenes() const
+{
+  return m_scenes;
+}
+
+// ------------------------------------------------------------------------------------------------
+Scene* HeadlessApplication::findScene(const std::string& name) const
+{
+  auto it = std::find_if(m_scenes.begin(), m_scenes.end(), [&name](const std::unique_ptr<Scene>& scene)
+                         {
+                           return name == scene->getName();
+                         });
+
+  return (it != m_scenes.end()) ? it->get() : nullptr;
+}
+
+// ------------------------------------------------------------------------------------------------
+void HeadlessApplication::load(Scene* scene)
+{
+  scene->construct(m_renderer.get());
+  m_renderer->start(scene);
+
+  m_steps = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+double HeadlessApplication::step(Scene* scene)
+{
+  using Clock = std::chrono::steady_clock;
+
+  UpdateData data;
+  data.parentToWorld = glm::mat4(1.0f);
+  data.localToWorld = glm::mat4(1.0f);
+  data.dt = h_step;
+  data.t = m_steps * h_step;
+  data.render = false;
+
+  Profiler& profiler = Profiler::getInstance();
+  profiler.beginFrame();
+
+  auto start = Clock::now();
+  m_renderer->update(scene, data);
+  std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+  profiler.endFrame();
+
+  ++m_steps;
+  return elapsed.count();
+}
+
+// ------------------------------------------------------------------------------------------------
+void HeadlessApplication::unload(Scene* scene)
+{
+  m_renderer->getCollisionManager()->clearAll();
+  scene->removeChildren();
+}
+
+// ------------------------------------------------------------------------------------------------
+HeadlessApplication::Timing HeadlessApplication::run(Scene* scene, size_t steps)
+{
+  load(scene);
+
+  Timing timing = {steps, 0.0, 0.0, 0.0};
+  for (size_t ii = 0; ii < steps; ++ii)
+  {
+    double elapsed = step(scene);
+
+    timing.totalTime += elapsed;
+    timing.maxStepTime = std::max(timing.maxStepTime, elapsed);
+  }
+  timing.meanStepTime = (steps > 0) ? timing.totalTime / steps : 0.0;
+
+  unload(scene);
+
+  return timing;
+}
+
+// ------------------------------------------------------------------------------------------------
+Renderer* HeadlessApplication::getRenderer() const
+{
+  return m_renderer.get();
+}
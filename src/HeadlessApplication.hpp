@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Renderer.hpp"
+
+#include "components/Scene.hpp"
+
+#include <memory>
+#include <vector>
+
+// Physics only application:
+// * no window, GL context nor ImGui, renderables skip their GPU resources
+// * scenes are constructed, stepped by h_step a given number of times, then cleared
+// * each step is a Profiler frame
+class HeadlessApplication final
+{
+public:
+  // Durations in milliseconds
+  struct Timing
+  {
+    size_t steps;
+    double totalTime;
+    double meanStepTime;
+    double maxStepTime;
+  };
+
+public:
+  HeadlessApplication();
+
+  const std::vector<std::unique_ptr<Scene>>& getScenes() const;
+  Scene* findScene(const std::string& name) const;
+
+  // One scene at a time: load, step as many times as needed, then unload
+  void load(Scene* scene);
+  double step(Scene* scene);
+  void unload(Scene* scene);
+
+  Timing run(Scene* scene, size_t steps);
+
+  Renderer* getRenderer() const;
+
+private:
+  std::unique_ptr<Renderer> m_renderer;
+  size_t m_steps;
+
+  std::vector<std::unique_ptr<Scene>> m_scenes;
+};
@@ -0,0 +1,79 @@
+#include "LodSelector.hpp"
+
+#include <algorithm>
+#include <limits>
+
+// ------------------------------------------------------------------------------------------------
+LodSelector::LodSelector()
+  : m_view(1.0f), m_focal(1.0f), m_detailThreshold(0.25f), m_stats{}
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+void LodSelector::setView(const glm::mat4& projection, const glm::mat4& view)
+{
+  m_view = view;
+  m_focal = projection[1][1];
+
+  m_stats = Stats{};
+}
+
+// ------------------------------------------------------------------------------------------------
+void LodSelector::setDetailThreshold(float threshold)
+{
+  m_detailThreshold = threshold;
+}
+
+// ------------------------------------------------------------------------------------------------
+float LodSelector::getDetailThreshold() const
+{
+  return m_detailThreshold;
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t LodSelector::select(const BoundingSphere& localBounds, const glm::mat4& localToWorld, size_t levelCount)
+{
+  size_t level = 0;
+
+  if (levelCount > 1)
+  {
+    const float size = projectedSize(localBounds, localToWorld);
+
+    float threshold = m_detailThreshold;
+    while (level + 1 < levelCount && size < threshold)
+    {
+      ++level;
+      threshold *= 0.5f;
+    }
+  }
+
+  ++m_stats.levels[std::min(level, MaxTrackedLevels - 1)];
+  return level;
+}
+
+// ------------------------------------------------------------------------------------------------
+const LodSelector::Stats& LodSelector::getStats() const
+{
+  return m_stats;
+}
+
+// ------------------------------------------------------------------------------------------------
+float LodSelector::projectedSize(const BoundingSphere& localBounds, const glm::mat4& localToWorld) const
+{
+  // Unbounded meshes always fill the screen
+  BoundingSphere bounds = localBounds.toWorld(localToWorld);
+  if (bounds.radius < 0.0f)
+  {
+    return std::numeric_limits<float>::infinity();
+  }
+
+  // The camera inside the sphere sees it whole
+  float distance = glm::length(glm::vec3(m_view * glm::vec4(bounds.center, 1.0f)));
+  if (distance <= bounds.radius)
+  {
+    return std::numeric_limits<float>::infinity();
+  }
+
+  // Diameter over the screen height (2 * tan(fov / 2) * distance)
+  return bounds.radius * m_focal / distance;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "StructInfo.hpp"
+
+#include <array>
+#include <cstddef>
+
+// Level of detail picked from the projected size of World bounding spheres:
+// * the size is the sphere diameter over the screen height, at the distance of its center
+// * the finest level is kept above the detail threshold, each coarser one halves it
+// * counts are kept from setView to the next one, for the statistics
+class LodSelector final
+{
+public:
+  // Coarser levels are counted with the last one
+  static constexpr size_t MaxTrackedLevels = 4;
+
+  struct Stats
+  {
+    std::array<size_t, MaxTrackedLevels> levels;
+  };
+
+public:
+  LodSelector();
+
+  // Camera of the render pass, resets the statistics
+  void setView(const glm::mat4& projection, const glm::mat4& view);
+
+  // Screen height fraction under which the finest level is dropped
+  void setDetailThreshold(float threshold);
+  float getDetailThreshold() const;
+
+  // Index in [0, levelCount), 0 being the finest
+  size_t select(const BoundingSphere& localBounds, const glm::mat4& localToWorld, size_t levelCount);
+
+  const Stats& getStats() const;
+
+private:
+  float projectedSize(const BoundingSphere& localBounds, const glm::mat4& localToWorld) const;
+
+private:
+  glm::mat4 m_view;
+
+  // Cotangent of the half vertical field of view
+  float m_focal;
+
+  float m_detailThreshold;
+
+  Stats m_stats;
+};
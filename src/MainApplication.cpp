@@ -5,17 +5,28 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/matrix_operation.hpp>
 #include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "asset.hpp"
 #include "glError.hpp"
+#include "Profiler.hpp"
 
+#include "components/CollisionSolver.hpp"
 #include "components/RigidBody.hpp"
 #include "components/Box.hpp"
 #include "components/Sphere.hpp"
 #include "components/TexturedMesh.hpp"
 
+#include "broadphases/BruteForce.hpp"
+#include "broadphases/SpatialHashGrid.hpp"
+#include "broadphases/SweepAndPrune.hpp"
+#include "broadphases/DynamicTree.hpp"
+
 #include "scenes/BowlingScene.hpp"
 #include "scenes/BowlsScene.hpp"
 #include "scenes/PoolScene.hpp"
@@ -29,7 +40,8 @@
 #include "imgui_impl_opengl3.h"
 
 MainApplication::MainApplication()
-    : Application(), m_currentSceneIndex(0), m_scenes(0), m_isPaused(false)
+    : Application(), m_scenes(0), m_currentSceneIndex(0), m_currentBroadphaseIndex(2), m_isParallelSolve(false),
+      m_isPaused(false), m_accumulator(0.0f), m_frameSteps(0)
 {
   m_renderer = std::make_unique<Renderer>(window);
 
@@ -67,6 +79,9 @@ void MainApplication::loop() {
   if (glfwWindowShouldClose(getWindow()))
     exit();
 
+  Profiler& profiler = Profiler::getInstance();
+  profiler.beginFrame();
+
   // set matrix : projection + view
   m_renderer->setProjection(glm::perspective(
       float(2.0 * atan(getHeight() / 1920.f)), getWindowRatio(), 0.1f, 100.f));
@@ -81,13 +96,38 @@ void MainApplication::loop() {
   ImGui_ImplGlfw_NewFrame();
   ImGui::NewFrame();
 
-  UpdateData data;
-  data.dt = m_isPaused ? 0.0f : h_step;
-  data.t = getTime();
+  if (!m_isPaused)
+  {
+    m_accumulator = std::min(m_accumulator + getFrameDeltaTime(), MaxSteps * h_step);
+  }
 
   if (m_currentSceneIndex > 0 && m_currentSceneIndex <= m_scenes.size())
   {
-    m_renderer->update(m_scenes[m_currentSceneIndex - 1].get(), data);
+    Scene* scene = m_scenes[m_currentSceneIndex - 1].get();
+
+    // Physics Steps
+    UpdateData step;
+    step.dt = h_step;
+    step.render = false;
+
+    m_frameSteps = 0;
+    while (m_accumulator >= h_step)
+    {
+      step.t = getTime() - m_accumulator;
+      m_renderer->update(scene, step);
+
+      m_accumulator -= h_step;
+      ++m_frameSteps;
+    }
+
+    // Render, between the last two steps
+    UpdateData data;
+    data.dt = getFrameDeltaTime();
+    data.t = getTime();
+    data.simulate = false;
+    data.alpha = m_accumulator / h_step;
+
+    m_renderer->update(scene, data);
   }
 
   // GUI Frame
@@ -116,14 +156,178 @@ void MainApplication::loop() {
       }
 
       ImGui::Checkbox("Paused", &m_isPaused);
+      ImGui::Text("Steps: %zu (%.1f ms frame)", m_frameSteps, 1000.0f * getFrameDeltaTime());
+      ImGui::Text("Shaders: %zu programs, %zu stages", m_renderer->getShaderCache().getProgramCount(),
+                  m_renderer->getShaderCache().getShaderCount());
+
+      const RenderQueue::Stats& drawStats = m_renderer->getRenderQueue().getLastStats();
+      ImGui::Text("Meshes: %zu unique, %zu draw calls, %zu instances", m_renderer->getMeshRegistry().size(),
+                  drawStats.drawCalls, drawStats.instances);
+      ImGui::Text("Binds: %zu programs, %zu textures, %zu VAOs", drawStats.programBinds,
+                  drawStats.textureBinds, drawStats.vaoBinds);
+
+      const FrustumCuller::Stats& cullStats = m_renderer->getFrustumCuller().getStats();
+      ImGui::Text("Culling: %zu drawn, %zu culled", cullStats.tested - cullStats.culled, cullStats.culled);
+
+      LodSelector& lodSelector = m_renderer->getLodSelector();
+      const LodSelector::Stats& lodStats = lodSelector.getStats();
+      ImGui::Text("LOD: %zu / %zu / %zu / %zu+", lodStats.levels[0], lodStats.levels[1], lodStats.levels[2],
+                  lodStats.levels[3]);
+
+      float detailThreshold = lodSelector.getDetailThreshold();
+      if (ImGui::SliderFloat("LOD Threshold", &detailThreshold, 0.01f, 1.0f))
+      {
+        lodSelector.setDetailThreshold(detailThreshold);
+      }
+    }
+
+    // Collision Detection
+    {
+      const char* broadphases[] = {"Brute Force", "Spatial Hash Grid", "Sweep and Prune", "Dynamic AABB Tree"};
+      if (ImGui::Combo("Broadphase", &m_currentBroadphaseIndex, broadphases, IM_ARRAYSIZE(broadphases)))
+      {
+        selectBroadphase(m_currentBroadphaseIndex);
+      }
+
+      auto collisionManager = m_renderer->getCollisionManager();
+
+      bool isParallel = collisionManager->isParallelNarrowphase();
+      if (ImGui::Checkbox("Parallel Narrowphase", &isParallel))
+      {
+        collisionManager->setParallelNarrowphase(isParallel);
+      }
+
+      const auto& stats = collisionManager->getStatistics();
+      ImGui::Text("Pairs: %zu (%zu sleeping), Contacts: %zu", stats.pairs, stats.sleepingPairs, stats.contacts);
+      ImGui::Text("Broadphase: %.3f ms", stats.broadphaseTime);
+      ImGui::Text("Narrowphase: %.3f ms", stats.narrowphaseTime);
+    }
+
+    // Collision Solver
+    if (m_currentSceneIndex > 0)
+    {
+      CollisionSolver* collisionSolver = m_scenes[m_currentSceneIndex - 1]->getCollisionSolver();
+
+      if (ImGui::Checkbox("Parallel Islands", &m_isParallelSolve))
+      {
+        collisionSolver->setParallelIslands(m_isParallelSolve);
+      }
+
+      ImGui::Text("Islands: %zu", collisionSolver->getIslandCount());
+    }
+
+    // Profiler
+    if (ImGui::CollapsingHeader("Profiler"))
+    {
+      bool isEnabled = Profiler::isEnabled();
+      if (ImGui::Checkbox("Record", &isEnabled))
+      {
+        profiler.setEnabled(isEnabled);
+      }
+
+      ImGui::SameLine();
+      if (ImGui::Button("Export Trace"))
+      {
+        const std::string path = "trace.json";
+        std::cout << "[Info] Trace " << (profiler.exportTrace(path) ? "written to " : "not written to ") << path << std::endl;
+      }
+
+      drawProfiler();
     }
 
     ImGui::End();
   }
 
   // ImGui Render
-  ImGui::Render();
-  ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  {
+    PROFILE_SCOPE("ImGui::Render");
+    ImGui::Render();
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  }
+
+  profiler.endFrame();
+}
+
+void MainApplication::drawProfiler()
+{
+  Profiler& profiler = Profiler::getInstance();
+
+  const Profiler::Frame& frame = profiler.getLastFrame();
+  const float frameDuration = (float) std::max<int64_t>(profiler.getLastFrameDuration(), 1);
+  ImGui::Text("Frame: %.3f ms, %zu scopes", frameDuration * 1e-6, frame.size());
+
+  // Timeline, one row per depth and thread
+  const float rowHeight = 18.0f;
+  uint32_t depths = 0, threads = 0;
+  for (const auto& event : frame)
+  {
+    depths = std::max(depths, event.depth + 1);
+    threads = std::max(threads, event.thread + 1);
+  }
+
+  ImVec2 origin = ImGui::GetCursorScreenPos();
+  float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+  ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+  for (const auto& event : frame)
+  {
+    float x0 = origin.x + width * (event.start - profiler.getLastFrameStart()) / frameDuration;
+    float x1 = std::max(x0 + 1.0f, x0 + width * event.duration / frameDuration);
+    float y0 = origin.y + rowHeight * (event.thread * depths + event.depth);
+    ImVec2 min(x0, y0), max(x1, y0 + rowHeight - 1.0f);
+
+    // Same color for every call of a scope
+    size_t hash = std::hash<const char*>()(event.name);
+    ImU32 color = IM_COL32(80 + hash % 150, 80 + (hash / 150) % 150, 80 + (hash / 22500) % 150, 255);
+    drawList->AddRectFilled(min, max, color);
+
+    if (x1 - x0 > 7.0f * std::strlen(event.name))
+    {
+      drawList->AddText(ImVec2(x0 + 2.0f, y0 + 2.0f), IM_COL32(0, 0, 0, 255), event.name);
+    }
+
+    if (ImGui::IsMouseHoveringRect(min, max))
+    {
+      ImGui::SetTooltip("%s: %.3f ms", event.name, event.duration * 1e-6);
+    }
+  }
+
+  ImGui::Dummy(ImVec2(width, rowHeight * depths * threads));
+
+  // Totals per scope, most expensive first
+  struct Total
+  {
+    const char* name;
+    size_t calls;
+    int64_t duration;
+  };
+
+  std::vector<Total> totals;
+  for (const auto& event : frame)
+  {
+    auto it = std::find_if(totals.begin(), totals.end(), [&event](const Total& total)
+                           {
+                             return total.name == event.name;
+                           });
+    if (it == totals.end())
+    {
+      totals.push_back(Total{ event.name, 0, 0 });
+      it = totals.end() - 1;
+    }
+
+    it->calls += 1;
+    it->duration += event.duration;
+  }
+
+  std::sort(totals.begin(), totals.end(), [](const Total& a, const Total& b)
+            {
+              return a.duration > b.duration;
+            });
+
+  for (const auto& total : totals)
+  {
+    ImGui::Text("%-36s %5zu x %8.3f ms", total.name, total.calls, total.duration * 1e-6);
+  }
 }
 
 void MainApplication::selectScene(int index)
@@ -135,11 +339,13 @@ void MainApplication::selectScene(int index)
 
   clearCurrentScene();
 
+  m_accumulator = 0.0f;
   m_currentSceneIndex = index;
   if (index > 0)
   {
     auto& scene = m_scenes[m_currentSceneIndex - 1];
     scene->construct(m_renderer.get());
+    scene->getCollisionSolver()->setParallelIslands(m_isParallelSolve);
     m_renderer->start(scene.get());
   }
 }
@@ -153,3 +359,19 @@ void MainApplication::clearCurrentScene()
     m_scenes[m_currentSceneIndex - 1]->removeChildren();
   }
 }
+
+void MainApplication::selectBroadphase(int index)
+{
+  std::unique_ptr<Broadphase> broadphase;
+
+  switch (index)
+  {
+    case 0: broadphase = std::make_unique<BruteForce>(); break;
+    case 1: broadphase = std::make_unique<SpatialHashGrid>(); break;
+    case 2: broadphase = std::make_unique<SweepAndPrune>(); break;
+    case 3: broadphase = std::make_unique<DynamicTree>(); break;
+    default: return;
+  }
+
+  m_renderer->getCollisionManager()->setBroadphase(std::move(broadphase));
+}
@@ -18,13 +18,23 @@ class MainApplication final : public Application {
 private:
   void selectScene(int index);
   void clearCurrentScene();
+  void selectBroadphase(int index);
+  void drawProfiler();
 
  private:
   std::unique_ptr<Renderer> m_renderer;
 
   std::vector<std::unique_ptr<Scene>> m_scenes;
   int m_currentSceneIndex;
+  int m_currentBroadphaseIndex;
+  bool m_isParallelSolve;
 
   // Time Manager
+  // - frame time is consumed by fixed h_step steps, the remainder is interpolated
+  // - at most MaxSteps steps per frame, slower frames slow the simulation down
+  static constexpr size_t MaxSteps = 5;
+
   bool m_isPaused;
+  float m_accumulator;
+  size_t m_frameSteps;
 };
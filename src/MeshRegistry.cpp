@@ -0,0 +1,199 @@
+#include "MeshRegistry.hpp"
+
+#include "asset.hpp"
+
+#include "glError.hpp"
+
+#include <cstring>
+#include <string_view>
+
+// ------------------------------------------------------------------------------------------------
+MeshRegistry::MeshRegistry(ShaderCache& shaderCache)
+  : m_shaderCache(shaderCache)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+MeshRegistry::~MeshRegistry()
+{
+  for (const auto& mesh : m_meshes)
+  {
+    GLuint buffers[] = { mesh->vbo, mesh->ibo, mesh->instanceVbo };
+    glDeleteBuffers(3, buffers);
+    glDeleteVertexArrays(1, &mesh->vao);
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+MeshRegistry::Mesh* MeshRegistry::acquire(const std::vector<VertexType>& vertices,
+                                          const std::vector<GLuint>& indexes, GLenum mode)
+{
+  const size_t key = hash(vertices, indexes, mode);
+
+  auto range = m_meshesByHash.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    Mesh* mesh = it->second;
+    // Vertices are plain floats, compared bytewise like they were hashed
+    if (mesh->mode == mode && mesh->indexes == indexes && mesh->vertices.size() == vertices.size() &&
+        std::memcmp(mesh->vertices.data(), vertices.data(), vertices.size() * sizeof(VertexType)) == 0)
+    {
+      return mesh;
+    }
+  }
+
+  Mesh* mesh = create(vertices, indexes, mode);
+  m_meshesByHash.emplace(key, mesh);
+  return mesh;
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshRegistry::addInstance(Mesh* mesh, const glm::mat4& localToWorld)
+{
+  if (mesh->instances.empty())
+  {
+    m_pendingMeshes.push_back(mesh);
+  }
+
+  mesh->instances.push_back(localToWorld);
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshRegistry::cull(FrustumCuller& culler)
+{
+  // One batch for the instances of every mesh
+  culler.clear();
+  for (Mesh* mesh : m_pendingMeshes)
+  {
+    for (const glm::mat4& instance : mesh->instances)
+    {
+      culler.add(mesh->bounds, instance);
+    }
+  }
+
+  const std::vector<uint8_t>& visibility = culler.computeVisibility();
+
+  size_t index = 0;
+  for (Mesh* mesh : m_pendingMeshes)
+  {
+    size_t kept = 0;
+    for (size_t instance = 0; instance < mesh->instances.size(); ++instance)
+    {
+      if (visibility[index++] != 0) mesh->instances[kept++] = mesh->instances[instance];
+    }
+    mesh->instances.resize(kept);
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshRegistry::submit(RenderQueue& queue)
+{
+  for (Mesh* mesh : m_pendingMeshes)
+  {
+    if (mesh->instances.empty())
+    {
+      continue;
+    }
+
+    RenderQueue::Packet packet{};
+    packet.program = mesh->shaderProgram.get();
+    packet.vao = mesh->vao;
+    packet.mode = mesh->mode;
+    packet.indexCount = mesh->indexCount;
+    packet.instanceVbo = mesh->instanceVbo;
+    packet.instances = &mesh->instances;
+
+    queue.submit(packet);
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshRegistry::clearInstances()
+{
+  for (Mesh* mesh : m_pendingMeshes)
+  {
+    mesh->instances.clear();
+  }
+
+  m_pendingMeshes.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t MeshRegistry::size() const
+{
+  return m_meshes.size();
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t MeshRegistry::hash(const std::vector<VertexType>& vertices, const std::vector<GLuint>& indexes, GLenum mode)
+{
+  std::hash<std::string_view> hasher;
+
+  size_t seed = hasher(std::string_view(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(VertexType)));
+  seed ^= hasher(std::string_view(reinterpret_cast<const char*>(indexes.data()), indexes.size() * sizeof(GLuint))) +
+          0x9e3779b9 + (seed << 6) + (seed >> 2);
+  seed ^= std::hash<GLenum>()(mode) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  return seed;
+}
+
+// ------------------------------------------------------------------------------------------------
+MeshRegistry::Mesh* MeshRegistry::create(const std::vector<VertexType>& vertices,
+                                         const std::vector<GLuint>& indexes, GLenum mode)
+{
+  auto mesh = std::make_unique<Mesh>();
+  mesh->indexCount = (GLsizei) indexes.size();
+  mesh->mode = mode;
+  mesh->bounds = BoundingSphere::fromVertices(vertices);
+  mesh->vertices = vertices;
+  mesh->indexes = indexes;
+
+  // shader
+  mesh->shaderProgram = m_shaderCache.getProgram(SHADER_DIR "/shader.vert", SHADER_DIR "/shader.frag");
+  glCheckError(__FILE__, __LINE__);
+
+  // vbo
+  glGenBuffers(1, &mesh->vbo);
+  glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(VertexType), vertices.data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // ibo
+  glGenBuffers(1, &mesh->ibo);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ibo);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexes.size() * sizeof(GLuint), indexes.data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  // instance vbo, filled before each draw
+  glGenBuffers(1, &mesh->instanceVbo);
+
+  // vao
+  glGenVertexArrays(1, &mesh->vao);
+  glBindVertexArray(mesh->vao);
+
+  // map vbo to shader attributes
+  glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+  mesh->shaderProgram->setAttribute("position", 3, sizeof(VertexType), offsetof(VertexType, position));
+  mesh->shaderProgram->setAttribute("normal", 3, sizeof(VertexType), offsetof(VertexType, normal));
+  mesh->shaderProgram->setAttribute("color", 4, sizeof(VertexType), offsetof(VertexType, color));
+
+  // model matrix, one column per attribute location, advancing once per instance (none if unused by the shader)
+  glBindBuffer(GL_ARRAY_BUFFER, mesh->instanceVbo);
+  GLint model = mesh->shaderProgram->attribute("model");
+  for (GLint column = 0; model >= 0 && column < 4; ++column)
+  {
+    glEnableVertexAttribArray(model + column);
+    glVertexAttribPointer(model + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                          reinterpret_cast<void*>(column * sizeof(glm::vec4)));
+    glVertexAttribDivisor(model + column, 1);
+  }
+
+  // bind the ibo
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ibo);
+
+  // vao end
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  m_meshes.push_back(std::move(mesh));
+  return m_meshes.back().get();
+}
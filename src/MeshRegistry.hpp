@@ -0,0 +1,73 @@
+#pragma once
+
+#include "FrustumCuller.hpp"
+#include "RenderQueue.hpp"
+#include "ShaderCache.hpp"
+#include "StructInfo.hpp"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Meshes shared by every Meshable drawn by a renderer:
+// * identical builder outputs are uploaded once, whatever the amount of components using them
+// * components add an instance per render pass, each mesh is then submitted as one instanced packet
+// * must be destroyed while the OpenGL context is still alive
+class MeshRegistry final
+{
+public:
+  struct Mesh
+  {
+    GLuint vao, vbo, ibo;
+    GLuint instanceVbo; // Model matrices, one per instance
+    GLsizei indexCount;
+    GLenum mode;
+
+    // Local bounds of the vertices, for the culling
+    BoundingSphere bounds;
+
+    std::shared_ptr<ShaderProgram> shaderProgram;
+
+    // Model matrices of the current render pass
+    std::vector<glm::mat4> instances;
+
+    // Uploaded content, compared when hashes match
+    std::vector<VertexType> vertices;
+    std::vector<GLuint> indexes;
+  };
+
+public:
+  MeshRegistry(ShaderCache& shaderCache);
+  ~MeshRegistry();
+
+  MeshRegistry(const MeshRegistry&) = delete;
+  MeshRegistry& operator=(const MeshRegistry&) = delete;
+
+  // Uploads the content unless an identical mesh already exists
+  Mesh* acquire(const std::vector<VertexType>& vertices, const std::vector<GLuint>& indexes, GLenum mode);
+
+  void addInstance(Mesh* mesh, const glm::mat4& localToWorld);
+
+  // Drops the instances outside of the culler frustum
+  void cull(FrustumCuller& culler);
+
+  // One instanced packet per mesh having instances, the instances are read when the queue executes
+  void submit(RenderQueue& queue);
+  void clearInstances();
+
+  size_t size() const;
+
+private:
+  static size_t hash(const std::vector<VertexType>& vertices, const std::vector<GLuint>& indexes, GLenum mode);
+
+  Mesh* create(const std::vector<VertexType>& vertices, const std::vector<GLuint>& indexes, GLenum mode);
+
+private:
+  ShaderCache& m_shaderCache;
+
+  std::vector<std::unique_ptr<Mesh>> m_meshes;
+  std::unordered_multimap<size_t, Mesh*> m_meshesByHash;
+
+  // Meshes having instances in the current render pass
+  std::vector<Mesh*> m_pendingMeshes;
+};
@@ -0,0 +1,201 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+std::atomic<bool> Profiler::s_enabled(false);
+
+namespace
+{
+  // Depth of the open scopes of the calling thread
+  thread_local uint32_t scopeDepth = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Scope::begin()
+{
+  m_start = getInstance().now();
+  ++scopeDepth;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Scope::end()
+{
+  --scopeDepth;
+
+  // Disabled meanwhile, the frame is being dropped
+  if (!isEnabled())
+  {
+    return;
+  }
+
+  Profiler& profiler = getInstance();
+  profiler.record(m_name, m_start, profiler.now(), scopeDepth);
+}
+
+// ------------------------------------------------------------------------------------------------
+Profiler::Profiler()
+  : m_epoch(std::chrono::steady_clock::now()),
+  m_frameStart(0), m_lastFrameStart(0), m_lastFrameDuration(0)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+Profiler& Profiler::getInstance()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::setEnabled(bool enabled)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  s_enabled.store(enabled, std::memory_order_relaxed);
+
+  clearThreadEvents();
+  m_currentFrame.clear();
+  m_lastFrame.clear();
+  m_lastFrameDuration = 0;
+  if (enabled)
+  {
+    m_traceFrames.clear();
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::beginFrame()
+{
+  if (!isEnabled())
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  clearThreadEvents();
+  m_currentFrame.clear();
+  m_frameStart = now();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::endFrame()
+{
+  if (!isEnabled())
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for (const auto& threadEvents : m_threadEvents)
+  {
+    std::lock_guard<std::mutex> threadLock(threadEvents->mutex);
+    m_currentFrame.insert(m_currentFrame.end(), threadEvents->events.begin(), threadEvents->events.end());
+    threadEvents->events.clear();
+  }
+
+  // Scopes are recorded when they end, parents after their children
+  std::sort(m_currentFrame.begin(), m_currentFrame.end(), [](const Event& a, const Event& b)
+            {
+              return (a.start != b.start) ? a.start < b.start : a.depth < b.depth;
+            });
+
+  m_lastFrameStart = m_frameStart;
+  m_lastFrameDuration = now() - m_frameStart;
+  m_lastFrame.swap(m_currentFrame);
+  m_currentFrame.clear();
+
+  m_traceFrames.push_back(m_lastFrame);
+  if (m_traceFrames.size() > MaxTraceFrames)
+  {
+    m_traceFrames.pop_front();
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+const Profiler::Frame& Profiler::getLastFrame() const
+{
+  return m_lastFrame;
+}
+
+// ------------------------------------------------------------------------------------------------
+int64_t Profiler::getLastFrameStart() const
+{
+  return m_lastFrameStart;
+}
+
+// ------------------------------------------------------------------------------------------------
+int64_t Profiler::getLastFrameDuration() const
+{
+  return m_lastFrameDuration;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Profiler::exportTrace(const std::string& path) const
+{
+  FILE* file = std::fopen(path.c_str(), "w");
+  if (file == nullptr)
+  {
+    return false;
+  }
+
+  // Complete events ("X"), times in microseconds
+  std::fprintf(file, "{\"traceEvents\":[\n");
+  bool first = true;
+  for (const Frame& frame : m_traceFrames)
+  {
+    for (const Event& event : frame)
+    {
+      std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+                   first ? "" : ",\n", event.name, event.start / 1000.0, event.duration / 1000.0, event.thread);
+      first = false;
+    }
+  }
+  std::fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+  return std::fclose(file) == 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+int64_t Profiler::now() const
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+}
+
+// ------------------------------------------------------------------------------------------------
+Profiler::ThreadEvents& Profiler::getThreadEvents()
+{
+  // Buffers belong to the profiler, they outlive their thread
+  thread_local ThreadEvents* threadEvents = nullptr;
+  if (threadEvents == nullptr)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_threadEvents.push_back(std::make_unique<ThreadEvents>());
+    threadEvents = m_threadEvents.back().get();
+    threadEvents->thread = (uint32_t) (m_threadEvents.size() - 1);
+  }
+
+  return *threadEvents;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::record(const char* name, int64_t start, int64_t end, uint32_t depth)
+{
+  ThreadEvents& threadEvents = getThreadEvents();
+
+  std::lock_guard<std::mutex> lock(threadEvents.mutex);
+  threadEvents.events.push_back(Event{ name, start, end - start, depth, threadEvents.thread });
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::clearThreadEvents()
+{
+  for (const auto& threadEvents : m_threadEvents)
+  {
+    std::lock_guard<std::mutex> lock(threadEvents->mutex);
+    threadEvents->events.clear();
+  }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Hierarchical frame profiler:
+// * PROFILE_SCOPE records the duration of the enclosing scope, nested scopes are one level deeper
+// * disabled scopes only test an atomic flag
+// * each thread records in its own buffer, merged into the frame by endFrame
+// * events are kept per frame, recent frames can be exported as a Chrome trace (chrome://tracing)
+class Profiler final
+{
+public:
+  // Times in nanoseconds since the profiler creation
+  struct Event
+  {
+    const char* name; // String literal
+    int64_t start;
+    int64_t duration;
+    uint32_t depth;
+    uint32_t thread;
+  };
+
+  using Frame = std::vector<Event>;
+
+  // Records from its construction to its destruction, only if the profiler was enabled then
+  class Scope final
+  {
+  public:
+    explicit Scope(const char* name);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    void begin();
+    void end();
+
+  private:
+    const char* m_name;
+    int64_t m_start;
+  };
+
+public:
+  static Profiler& getInstance();
+
+  static bool isEnabled();
+  void setEnabled(bool enabled);
+
+  // Events recorded between the two calls form a frame
+  void beginFrame();
+  void endFrame();
+
+  // Last completed frame, empty while disabled
+  const Frame& getLastFrame() const;
+  int64_t getLastFrameStart() const;
+  int64_t getLastFrameDuration() const;
+
+  // Writes the kept frames, returns false if the file cannot be written
+  bool exportTrace(const std::string& path) const;
+
+private:
+  // Events of a thread for the current frame
+  struct ThreadEvents
+  {
+    std::mutex mutex; // Only contended while a frame begins or ends
+    Frame events;
+    uint32_t thread;
+  };
+
+private:
+  Profiler();
+
+  int64_t now() const;
+  ThreadEvents& getThreadEvents();
+  void record(const char* name, int64_t start, int64_t end, uint32_t depth);
+  void clearThreadEvents();
+
+private:
+  // Frames kept for the trace export
+  static constexpr size_t MaxTraceFrames = 300;
+
+  static std::atomic<bool> s_enabled;
+
+  std::chrono::steady_clock::time_point m_epoch;
+
+  // Frames and thread registration, never locked by a recording scope
+  std::mutex m_mutex;
+  Frame m_currentFrame;
+  Frame m_lastFrame;
+  int64_t m_frameStart;
+  int64_t m_lastFrameStart;
+  int64_t m_lastFrameDuration;
+  std::deque<Frame> m_traceFrames;
+  std::vector<std::unique_ptr<ThreadEvents>> m_threadEvents;
+};
+
+// ------------------------------------------------------------------------------------------------
+inline bool Profiler::isEnabled()
+{
+  return s_enabled.load(std::memory_order_relaxed);
+}
+
+// ------------------------------------------------------------------------------------------------
+inline Profiler::Scope::Scope(const char* name)
+  : m_name(nullptr), m_start(0)
+{
+  if (isEnabled())
+  {
+    m_name = name;
+    begin();
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+inline Profiler::Scope::~Scope()
+{
+  if (m_name != nullptr)
+  {
+    end();
+  }
+}
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
@@ -0,0 +1,160 @@
+#include "RenderQueue.hpp"
+
+#include "Profiler.hpp"
+#include "glError.hpp"
+
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+RenderQueue::RenderQueue()
+  : m_cameraBuffer(ShaderCache::CameraBlockBinding, sizeof(CameraBlock)),
+  m_objectBuffer(ShaderCache::ObjectBlockBinding, sizeof(glm::mat4)),
+  m_lastStats{ 0, 0, 0, 0, 0, 0 }
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+void RenderQueue::submit(const Packet& packet)
+{
+  m_packets.push_back(packet);
+  m_packets.back().key = makeKey(packet);
+}
+
+// ------------------------------------------------------------------------------------------------
+void RenderQueue::cull(FrustumCuller& culler)
+{
+  culler.clear();
+  for (const Packet& packet : m_packets)
+  {
+    if (packet.instances == nullptr)
+    {
+      culler.add(packet.bounds, packet.model);
+    }
+  }
+
+  const std::vector<uint8_t>& visibility = culler.computeVisibility();
+
+  size_t index = 0;
+  size_t kept = 0;
+  for (size_t packet = 0; packet < m_packets.size(); ++packet)
+  {
+    if (m_packets[packet].instances == nullptr && visibility[index++] == 0) continue;
+    m_packets[kept++] = m_packets[packet];
+  }
+  m_packets.resize(kept);
+}
+
+// ------------------------------------------------------------------------------------------------
+void RenderQueue::execute(const glm::mat4& projection, const glm::mat4& view)
+{
+  PROFILE_SCOPE("RenderQueue::execute");
+
+  // Stable, packets sharing every state keep their submission order
+  std::stable_sort(m_packets.begin(), m_packets.end(), [](const Packet& a, const Packet& b)
+                   {
+                     return a.key < b.key;
+                   });
+
+  m_lastStats = Stats{ m_packets.size(), 0, 0, 0, 0, 0 };
+
+  // Camera for every program, models of the single draws in their draw order
+  const CameraBlock camera{ projection, view };
+  m_cameraBuffer.upload(&camera, 1);
+  m_cameraBuffer.bind(0);
+
+  m_models.clear();
+  for (const Packet& packet : m_packets)
+  {
+    if (packet.instances == nullptr)
+    {
+      m_models.push_back(packet.model);
+    }
+  }
+  m_objectBuffer.upload(m_models.data(), m_models.size());
+  size_t objectBlock = 0;
+
+  ShaderProgram* currentProgram = nullptr;
+  GLuint currentTexture = 0;
+  GLuint currentVao = 0;
+
+  for (const Packet& packet : m_packets)
+  {
+    // Instanced packets with nothing to draw
+    if (packet.instances != nullptr && packet.instances->empty())
+    {
+      continue;
+    }
+
+    if (packet.program != currentProgram)
+    {
+      currentProgram = packet.program;
+      currentProgram->use();
+      ++m_lastStats.programBinds;
+    }
+
+    if (packet.texture != currentTexture)
+    {
+      currentTexture = packet.texture;
+      glActiveTexture(GL_TEXTURE0);
+      glBindTexture(GL_TEXTURE_2D, currentTexture);
+      ++m_lastStats.textureBinds;
+    }
+
+    if (packet.vao != currentVao)
+    {
+      currentVao = packet.vao;
+      glBindVertexArray(currentVao);
+      ++m_lastStats.vaoBinds;
+    }
+
+    const void* indexOffset = reinterpret_cast<const void*>(packet.firstIndex * sizeof(GLuint));
+
+    if (packet.instances != nullptr)
+    {
+      const GLsizei instanceCount = (GLsizei) packet.instances->size();
+
+      // Orphaned every pass, the driver does not wait for the previous draws
+      glBindBuffer(GL_ARRAY_BUFFER, packet.instanceVbo);
+      glBufferData(GL_ARRAY_BUFFER, instanceCount * sizeof(glm::mat4), packet.instances->data(), GL_STREAM_DRAW);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      glDrawElementsInstanced(packet.mode, packet.indexCount, GL_UNSIGNED_INT, indexOffset, instanceCount);
+      m_lastStats.instances += instanceCount;
+    }
+    else
+    {
+      m_objectBuffer.bind(objectBlock++);
+
+      glDrawElements(packet.mode, packet.indexCount, GL_UNSIGNED_INT, indexOffset);
+      ++m_lastStats.instances;
+    }
+
+    ++m_lastStats.drawCalls;
+  }
+
+  if (currentProgram != nullptr)
+  {
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    currentProgram->unuse();
+  }
+
+  glCheckError(__FILE__, __LINE__);
+
+  m_packets.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+const RenderQueue::Stats& RenderQueue::getLastStats() const
+{
+  return m_lastStats;
+}
+
+// ------------------------------------------------------------------------------------------------
+uint64_t RenderQueue::makeKey(const Packet& packet)
+{
+  // Program switches cost the most, then textures, then VAOs
+  return (uint64_t(packet.program->getHandle() & 0xFFFF) << 48) |
+         (uint64_t(packet.texture & 0xFFFF) << 32) |
+         uint64_t(packet.vao);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "FrustumCuller.hpp"
+#include "ShaderCache.hpp"
+#include "UniformBuffer.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Draws gathered during the render pass, submitted once it is done:
+// * components only record packets, no OpenGL call happens during the traversal
+// * packets are sorted by program, texture then VAO, binds of the state already in place are skipped
+// * recording and submission share no state but the packets, the latter can move to the GL thread
+// * camera and model matrices go through uniform buffers, uploaded once per execution
+class RenderQueue final
+{
+public:
+  struct Packet
+  {
+    uint64_t key; // Filled by submit
+
+    ShaderProgram* program;
+    GLuint vao;
+    GLuint texture; // 0 if untextured
+    GLenum mode;
+    GLsizei indexCount;
+    GLsizei firstIndex; // Offset in the bound ibo, for meshes sharing one
+
+    // Single draws read the model matrix from the "Object" block, and are culled by their bounds
+    glm::mat4 model;
+    BoundingSphere bounds;
+
+    // Instanced draws stream the model matrices into their instance buffer instead
+    GLuint instanceVbo;
+    const std::vector<glm::mat4>* instances;
+  };
+
+  // Of the last executed queue
+  struct Stats
+  {
+    size_t packets;
+    size_t drawCalls;
+    size_t instances;
+    size_t programBinds;
+    size_t textureBinds;
+    size_t vaoBinds;
+  };
+
+public:
+  RenderQueue();
+
+  void submit(const Packet& packet);
+
+  // Drops the single draws outside of the culler frustum, instanced ones are culled at their source
+  void cull(FrustumCuller& culler);
+
+  // Sorts and draws the packets, then clears the queue
+  void execute(const glm::mat4& projection, const glm::mat4& view);
+
+  const Stats& getLastStats() const;
+
+private:
+  // std140 layout of the "Camera" block
+  struct CameraBlock
+  {
+    glm::mat4 projection;
+    glm::mat4 view;
+  };
+
+  static uint64_t makeKey(const Packet& packet);
+
+private:
+  std::vector<Packet> m_packets;
+
+  UniformBuffer m_cameraBuffer;
+  UniformBuffer m_objectBuffer;
+  std::vector<glm::mat4> m_models;
+
+  Stats m_lastStats;
+};
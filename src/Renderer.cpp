@@ -1,5 +1,6 @@
 #include "Renderer.hpp"
 #include "asset.hpp"
+#include "Profiler.hpp"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -7,7 +8,8 @@
 
 // ------------------------------------------------------------------------------------------------
 Renderer::Renderer(GLFWwindow* _window)
-  : window(_window), collisionManager(std::make_shared<CollisionManager>())
+  : window(_window), collisionManager(std::make_shared<CollisionManager>()),
+  meshRegistry(shaderCache)
 {
 }
 
@@ -20,7 +22,32 @@ void Renderer::start(Component* scene)
 // ------------------------------------------------------------------------------------------------
 void Renderer::update(Component* scene, UpdateData data)
 {
+  PROFILE_SCOPE("Renderer::update");
+
+  if (isHeadless())
+  {
+    data.render = false;
+  }
+
+  // The camera updates the view during the traversal, levels are picked with the one of the previous pass
+  if (data.render)
+  {
+    lodSelector.setView(projection, view);
+  }
+
   scene->update(this, data);
+
+  if (data.render)
+  {
+    // Objects out of view never reach the submission
+    frustumCuller.setFrustum(projection * view);
+    meshRegistry.cull(frustumCuller);
+    renderQueue.cull(frustumCuller);
+
+    meshRegistry.submit(renderQueue);
+    renderQueue.execute(projection, view);
+    meshRegistry.clearInstances();
+  }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -53,8 +80,44 @@ GLFWwindow* Renderer::getWindow() const
   return window;
 }
 
+// ------------------------------------------------------------------------------------------------
+bool Renderer::isHeadless() const
+{
+  return window == nullptr;
+}
+
 // ------------------------------------------------------------------------------------------------
 std::shared_ptr<CollisionManager> Renderer::getCollisionManager() const
 {
   return collisionManager;
 }
+
+// ------------------------------------------------------------------------------------------------
+ShaderCache& Renderer::getShaderCache()
+{
+  return shaderCache;
+}
+
+// ------------------------------------------------------------------------------------------------
+MeshRegistry& Renderer::getMeshRegistry()
+{
+  return meshRegistry;
+}
+
+// ------------------------------------------------------------------------------------------------
+RenderQueue& Renderer::getRenderQueue()
+{
+  return renderQueue;
+}
+
+// ------------------------------------------------------------------------------------------------
+const FrustumCuller& Renderer::getFrustumCuller() const
+{
+  return frustumCuller;
+}
+
+// ------------------------------------------------------------------------------------------------
+LodSelector& Renderer::getLodSelector()
+{
+  return lodSelector;
+}
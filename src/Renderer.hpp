@@ -2,7 +2,12 @@
 
 #include "Application.hpp"
 #include "Shader.hpp"
+#include "ShaderCache.hpp"
 #include "CollisionManager.hpp"
+#include "FrustumCuller.hpp"
+#include "LodSelector.hpp"
+#include "MeshRegistry.hpp"
+#include "RenderQueue.hpp"
 
 #include "components/Component.hpp"
 
@@ -23,8 +28,26 @@ public:
 
   GLFWwindow* getWindow() const;
 
+  // Without a window, nothing is drawn nor allocated on the GPU
+  bool isHeadless() const;
+
   std::shared_ptr<CollisionManager> getCollisionManager() const;
 
+  // Programs shared by the renderables drawn by this renderer
+  ShaderCache& getShaderCache();
+
+  // Meshes of the renderables, submitted at the end of each render pass
+  MeshRegistry& getMeshRegistry();
+
+  // Draws recorded during the render pass, executed once the traversal is done
+  RenderQueue& getRenderQueue();
+
+  // Frustum of the last render pass
+  const FrustumCuller& getFrustumCuller() const;
+
+  // Levels of detail picked by the renderables during the render pass
+  LodSelector& getLodSelector();
+
 private:
   glm::mat4 projection = glm::mat4(1.0);
   glm::mat4 view = glm::mat4(1.0);
@@ -32,4 +55,10 @@ private:
   GLFWwindow* window;
 
   std::shared_ptr<CollisionManager> collisionManager;
+
+  ShaderCache shaderCache;
+  MeshRegistry meshRegistry;
+  RenderQueue renderQueue;
+  FrustumCuller frustumCuller;
+  LodSelector lodSelector;
 };
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <utility>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SEPARATING_AXIS_SSE
+#endif
+
+// ------------------------------------------------------------------------------------------------
+// Batched corner projections for the OBB Separating Axis Test:
+// * AVX projects the 8 corners at once, SSE in two halves, others fall back on scalar code
+// * every path computes the same values as glm::dot, so results do not depend on the target
+namespace SeparatingAxis
+{
+  using Interval = std::pair<float, float>; // First: Lower, Second: Upper
+
+  // OBB corners laid out per coordinate
+  struct Corners
+  {
+    alignas(32) std::array<float, 8> x;
+    alignas(32) std::array<float, 8> y;
+    alignas(32) std::array<float, 8> z;
+  };
+
+  // Corners of a box of given half extents, placed in World space
+  inline Corners makeCorners(const glm::mat4& transform, const glm::vec3& halfExtents)
+  {
+    Corners result;
+
+    for (size_t ii = 0; ii < 8; ++ii)
+    {
+      glm::vec3 corner = halfExtents;
+      if ((ii & 1) == 0) corner.x = -corner.x;
+      if ((ii & 2) == 0) corner.y = -corner.y;
+      if ((ii & 4) == 0) corner.z = -corner.z;
+
+      glm::vec3 world = transform * glm::vec4(corner, 1.0);
+      result.x[ii] = world.x;
+      result.y[ii] = world.y;
+      result.z[ii] = world.z;
+    }
+
+    return result;
+  }
+
+  // Interval of the corners projection on axis
+  inline Interval project(const glm::vec3& axis, const Corners& corners)
+  {
+#if defined(__AVX__)
+    __m256 proj = _mm256_add_ps(
+      _mm256_add_ps(
+        _mm256_mul_ps(_mm256_set1_ps(axis.x), _mm256_loadu_ps(corners.x.data())),
+        _mm256_mul_ps(_mm256_set1_ps(axis.y), _mm256_loadu_ps(corners.y.data()))),
+      _mm256_mul_ps(_mm256_set1_ps(axis.z), _mm256_loadu_ps(corners.z.data())));
+
+    __m128 lower = _mm_min_ps(_mm256_castps256_ps128(proj), _mm256_extractf128_ps(proj, 1));
+    __m128 upper = _mm_max_ps(_mm256_castps256_ps128(proj), _mm256_extractf128_ps(proj, 1));
+#elif defined(SEPARATING_AXIS_SSE)
+    __m128 ax = _mm_set1_ps(axis.x);
+    __m128 ay = _mm_set1_ps(axis.y);
+    __m128 az = _mm_set1_ps(axis.z);
+
+    auto half = [&](size_t offset) -> __m128
+    {
+      return _mm_add_ps(
+        _mm_add_ps(
+          _mm_mul_ps(ax, _mm_loadu_ps(corners.x.data() + offset)),
+          _mm_mul_ps(ay, _mm_loadu_ps(corners.y.data() + offset))),
+        _mm_mul_ps(az, _mm_loadu_ps(corners.z.data() + offset)));
+    };
+
+    __m128 proj0 = half(0);
+    __m128 proj1 = half(4);
+
+    __m128 lower = _mm_min_ps(proj0, proj1);
+    __m128 upper = _mm_max_ps(proj0, proj1);
+#endif
+
+#if defined(__AVX__) || defined(SEPARATING_AXIS_SSE)
+    // Horizontal reduction of the 4 remaining lanes
+    lower = _mm_min_ps(lower, _mm_movehl_ps(lower, lower));
+    upper = _mm_max_ps(upper, _mm_movehl_ps(upper, upper));
+    lower = _mm_min_ss(lower, _mm_shuffle_ps(lower, lower, 1));
+    upper = _mm_max_ss(upper, _mm_shuffle_ps(upper, upper, 1));
+
+    return std::make_pair(_mm_cvtss_f32(lower), _mm_cvtss_f32(upper));
+#else
+    float proj = axis.x * corners.x[0] + axis.y * corners.y[0] + axis.z * corners.z[0];
+    Interval result = std::make_pair(proj, proj);
+
+    for (size_t ii = 1; ii < 8; ++ii)
+    {
+      proj = axis.x * corners.x[ii] + axis.y * corners.y[ii] + axis.z * corners.z[ii];
+      if (proj > result.second) result.second = proj;
+      else if (proj < result.first) result.first = proj;
+    }
+
+    return result;
+#endif
+  }
+}
@@ -53,11 +53,11 @@ Shader::Shader(const std::string& filename, GLenum type) {
     GLsizei logsize = 0;
     glGetShaderiv(handle, GL_INFO_LOG_LENGTH, &logsize);
 
-    char* log = new char[logsize + 1];
-    glGetShaderInfoLog(handle, logsize, &logsize, log);
+    vector<char> log(logsize + 1, '\0');
+    glGetShaderInfoLog(handle, logsize, &logsize, log.data());
 
     cout << "[Error] compilation error: " << filename << endl;
-    cout << log << endl;
+    cout << log.data() << endl;
 
     exit(EXIT_FAILURE);
   } else {
@@ -69,7 +69,9 @@ GLuint Shader::getHandle() const {
   return handle;
 }
 
-Shader::~Shader() {}
+Shader::~Shader() {
+  glDeleteShader(handle);
+}
 
 ShaderProgram::ShaderProgram() {
   handle = glCreateProgram();
@@ -77,12 +79,16 @@ ShaderProgram::ShaderProgram() {
     throw std::runtime_error("Impossible to create a new shader program");
 }
 
-ShaderProgram::ShaderProgram(std::initializer_list<Shader> shaderList)
+ShaderProgram::ShaderProgram(std::initializer_list<const Shader*> shaderList)
     : ShaderProgram() {
-  for (auto& s : shaderList)
-    glAttachShader(handle, s.getHandle());
+  for (auto s : shaderList)
+    glAttachShader(handle, s->getHandle());
 
   link();
+
+  // the linked program no longer needs them
+  for (auto s : shaderList)
+    glDetachShader(handle, s->getHandle());
 }
 
 void ShaderProgram::link() {
@@ -95,34 +101,88 @@ void ShaderProgram::link() {
     GLsizei logsize = 0;
     glGetProgramiv(handle, GL_INFO_LOG_LENGTH, &logsize);
 
-    char* log = new char[logsize];
-    glGetProgramInfoLog(handle, logsize, &logsize, log);
+    vector<char> log(logsize + 1, '\0');
+    glGetProgramInfoLog(handle, logsize, &logsize, log.data());
+
+    cout << log.data() << endl;
+    return;
+  }
+
+  resolveLocations();
+}
+
+void ShaderProgram::resolveLocations() {
+  // uniforms, those of blocks have no location
+  GLint count = 0, maxLength = 0;
+  glGetProgramiv(handle, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+  vector<char> name(maxLength + 1, '\0');
+  for (GLint i = 0; i < count; ++i) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(handle, i, maxLength, &length, &size, &type, name.data());
+
+    string uniformName(name.data(), length);
+    GLint location = glGetUniformLocation(handle, uniformName.c_str());
+    if (location < 0)
+      continue;
+
+    // arrays are reported as "name[0]"
+    uniforms[uniformName] = location;
+    if (uniformName.size() > 3 &&
+        uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+      uniforms[uniformName.substr(0, uniformName.size() - 3)] = location;
+  }
 
-    cout << log << endl;
+  // attributes
+  count = 0;
+  maxLength = 0;
+  glGetProgramiv(handle, GL_ACTIVE_ATTRIBUTES, &count);
+  glGetProgramiv(handle, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+  name.assign(maxLength + 1, '\0');
+  for (GLint i = 0; i < count; ++i) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveAttrib(handle, i, maxLength, &length, &size, &type, name.data());
+
+    string attributeName(name.data(), length);
+    attributes[attributeName] = glGetAttribLocation(handle, attributeName.c_str());
   }
 }
 
+bool ShaderProgram::bindUniformBlock(const std::string& name, GLuint binding) {
+  GLuint index = glGetUniformBlockIndex(handle, name.c_str());
+  if (index == GL_INVALID_INDEX)
+    return false;
+
+  glUniformBlockBinding(handle, index, binding);
+  return true;
+}
+
 GLint ShaderProgram::uniform(const std::string& name) {
   auto it = uniforms.find(name);
   if (it == uniforms.end()) {
-    // uniform that is not referenced
-    GLint r = glGetUniformLocation(handle, name.c_str());
-    if (r == GL_INVALID_OPERATION || r < 0)
-      cout << "[Error] uniform " << name << " doesn't exist in program" << endl;
-    // add it anyways
-    uniforms[name] = r;
-
-    return r;
+    // uniform that is not referenced, reported once
+    cout << "[Error] uniform " << name << " doesn't exist in program" << endl;
+    uniforms[name] = -1;
+
+    return -1;
   } else
     return it->second;
 }
 
 GLint ShaderProgram::attribute(const std::string& name) {
-  GLint attrib = glGetAttribLocation(handle, name.c_str());
-  if (attrib == GL_INVALID_OPERATION || attrib < 0)
+  auto it = attributes.find(name);
+  if (it == attributes.end()) {
+    // attribute that is not referenced, reported once
     cout << "[Error] Attribute " << name << " doesn't exist in program" << endl;
+    attributes[name] = -1;
 
-  return attrib;
+    return -1;
+  } else
+    return it->second;
 }
 
 void ShaderProgram::setAttribute(const std::string& name,
@@ -204,7 +264,7 @@ void ShaderProgram::setUniform(const std::string& name, int val) {
 }
 
 ShaderProgram::~ShaderProgram() {
-  // glDeleteProgram(handle);
+  glDeleteProgram(handle);
 }
 
 void ShaderProgram::use() const {
@@ -20,6 +20,10 @@ class Shader {
   // provide opengl shader identifiant.
   GLuint getHandle() const;
 
+  // the handle is owned, shaders are shared through the ShaderCache instead
+  Shader(const Shader&) = delete;
+  Shader& operator=(const Shader&) = delete;
+
   ~Shader();
 
  private:
@@ -36,8 +40,12 @@ class Shader {
 // using GLM objects.
 class ShaderProgram {
  public:
-  // constructor
-  ShaderProgram(std::initializer_list<Shader> shaderList);
+  // constructor, the shaders can be released once linked
+  ShaderProgram(std::initializer_list<const Shader*> shaderList);
+
+  // the handle is owned, programs are shared through the ShaderCache instead
+  ShaderProgram(const ShaderProgram&) = delete;
+  ShaderProgram& operator=(const ShaderProgram&) = delete;
 
   // bind the program
   void use() const;
@@ -47,7 +55,7 @@ class ShaderProgram {
   GLuint getHandle() const;
 
   // clang-format off
-  // provide attributes informations.
+  // provide attributes informations, locations are resolved when linked.
   GLint attribute(const std::string& name);
   void setAttribute(const std::string& name, GLint size, GLsizei stride, GLuint offset, GLboolean normalize, GLenum type);
   void setAttribute(const std::string& name, GLint size, GLsizei stride, GLuint offset, GLboolean normalize);
@@ -55,10 +63,13 @@ class ShaderProgram {
   void setAttribute(const std::string& name, GLint size, GLsizei stride, GLuint offset);
   // clang-format on
 
-  // provide uniform location
+  // provide uniform location, resolved when linked
   GLint uniform(const std::string& name);
   GLint operator[](const std::string& name);
 
+  // bind a uniform block to a binding point, false if the program has no such block
+  bool bindUniformBlock(const std::string& name, GLuint binding);
+
   // affect uniform
   void setUniform(const std::string& name, float x, float y, float z);
   void setUniform(const std::string& name, const glm::vec3& v);
@@ -83,4 +94,5 @@ class ShaderProgram {
   GLuint handle;
 
   void link();
+  void resolveLocations();
 };
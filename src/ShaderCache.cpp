@@ -0,0 +1,57 @@
+#include "ShaderCache.hpp"
+
+// ------------------------------------------------------------------------------------------------
+std::shared_ptr<Shader> ShaderCache::getShader(const std::string& filename, GLenum type)
+{
+  Stage key(filename, type);
+
+  auto it = m_shaders.find(key);
+  if (it != m_shaders.end())
+  {
+    return it->second;
+  }
+
+  auto shader = std::make_shared<Shader>(filename, type);
+  m_shaders.emplace(std::move(key), shader);
+  return shader;
+}
+
+// ------------------------------------------------------------------------------------------------
+std::shared_ptr<ShaderProgram> ShaderCache::getProgram(const std::string& vertexFile, const std::string& fragmentFile)
+{
+  std::vector<Stage> key = { Stage(vertexFile, GL_VERTEX_SHADER), Stage(fragmentFile, GL_FRAGMENT_SHADER) };
+
+  auto it = m_programs.find(key);
+  if (it != m_programs.end())
+  {
+    return it->second;
+  }
+
+  std::shared_ptr<Shader> vertexShader = getShader(vertexFile, GL_VERTEX_SHADER);
+  std::shared_ptr<Shader> fragmentShader = getShader(fragmentFile, GL_FRAGMENT_SHADER);
+
+  auto program = std::make_shared<ShaderProgram>(std::initializer_list<const Shader*>{ vertexShader.get(), fragmentShader.get() });
+  program->bindUniformBlock("Camera", CameraBlockBinding);
+  program->bindUniformBlock("Object", ObjectBlockBinding);
+  m_programs.emplace(std::move(key), program);
+  return program;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ShaderCache::clear()
+{
+  m_programs.clear();
+  m_shaders.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t ShaderCache::getShaderCount() const
+{
+  return m_shaders.size();
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t ShaderCache::getProgramCount() const
+{
+  return m_programs.size();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Shader.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Shaders and programs shared by every renderable:
+// * each source file is read and compiled once per stage, each set of stages linked once
+// * programs stay cached until the cache is destroyed, scene restarts reuse them
+// * the engine uniform blocks are bound to their fixed binding points when linked
+// * must be destroyed while the OpenGL context is still alive
+class ShaderCache final
+{
+public:
+  // Source path and shader type
+  using Stage = std::pair<std::string, GLenum>;
+
+  // Binding points of the uniform blocks shared by every program
+  static constexpr GLuint CameraBlockBinding = 0; // "Camera": projection, view
+  static constexpr GLuint ObjectBlockBinding = 1; // "Object": model
+
+public:
+  ShaderCache() = default;
+
+  ShaderCache(const ShaderCache&) = delete;
+  ShaderCache& operator=(const ShaderCache&) = delete;
+
+  std::shared_ptr<Shader> getShader(const std::string& filename, GLenum type);
+  std::shared_ptr<ShaderProgram> getProgram(const std::string& vertexFile, const std::string& fragmentFile);
+
+  // Releases everything, programs still in use stay alive with their users
+  void clear();
+
+  size_t getShaderCount() const;
+  size_t getProgramCount() const;
+
+private:
+  std::map<Stage, std::shared_ptr<Shader>> m_shaders;
+  std::map<std::vector<Stage>, std::shared_ptr<ShaderProgram>> m_programs;
+};
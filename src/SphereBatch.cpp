@@ -0,0 +1,117 @@
+#include "SphereBatch.hpp"
+
+#include "components/SphereCollider.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SPHERE_BATCH_SSE
+#endif
+
+// ------------------------------------------------------------------------------------------------
+SphereBatch::SphereBatch()
+  : m_pairs(0), m_offsetsX(0), m_offsetsY(0), m_offsetsZ(0), m_radiusesSums(0), m_overlaps(0)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+void SphereBatch::clear()
+{
+  m_pairs.clear();
+
+  m_offsetsX.clear();
+  m_offsetsY.clear();
+  m_offsetsZ.clear();
+  m_radiusesSums.clear();
+
+  m_overlaps.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+void SphereBatch::addPair(SphereCollider* sphere1, SphereCollider* sphere2)
+{
+  glm::vec3 offset = sphere2->getWorldCenter() - sphere1->getWorldCenter();
+
+  m_pairs.push_back(std::make_pair(sphere1, sphere2));
+
+  m_offsetsX.push_back(offset.x);
+  m_offsetsY.push_back(offset.y);
+  m_offsetsZ.push_back(offset.z);
+  m_radiusesSums.push_back(sphere1->getRadius() + sphere2->getRadius());
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t SphereBatch::size() const
+{
+  return m_pairs.size();
+}
+
+// ------------------------------------------------------------------------------------------------
+SphereBatch::Pair SphereBatch::getPair(size_t index) const
+{
+  return m_pairs[index];
+}
+
+// ------------------------------------------------------------------------------------------------
+const std::vector<uint32_t>& SphereBatch::computeOverlaps()
+{
+  m_overlaps.clear();
+
+  const size_t size = m_pairs.size();
+  size_t index = 0;
+
+  // NGT comparisons keep NaN distances as overlaps, like the scalar test
+#if defined(__AVX__)
+  for (; index + 8 <= size; index += 8)
+  {
+    __m256 x = _mm256_loadu_ps(m_offsetsX.data() + index);
+    __m256 y = _mm256_loadu_ps(m_offsetsY.data() + index);
+    __m256 z = _mm256_loadu_ps(m_offsetsZ.data() + index);
+    __m256 r = _mm256_loadu_ps(m_radiusesSums.data() + index);
+
+    __m256 sqrDistance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+    int mask = _mm256_movemask_ps(_mm256_cmp_ps(sqrDistance, _mm256_mul_ps(r, r), _CMP_NGT_UQ));
+
+    for (int lane = 0; lane < 8; ++lane)
+    {
+      if ((mask & (1 << lane)) != 0) m_overlaps.push_back((uint32_t) (index + lane));
+    }
+  }
+#elif defined(SPHERE_BATCH_SSE)
+  for (; index + 4 <= size; index += 4)
+  {
+    __m128 x = _mm_loadu_ps(m_offsetsX.data() + index);
+    __m128 y = _mm_loadu_ps(m_offsetsY.data() + index);
+    __m128 z = _mm_loadu_ps(m_offsetsZ.data() + index);
+    __m128 r = _mm_loadu_ps(m_radiusesSums.data() + index);
+
+    __m128 sqrDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+    int mask = _mm_movemask_ps(_mm_cmpngt_ps(sqrDistance, _mm_mul_ps(r, r)));
+
+    for (int lane = 0; lane < 4; ++lane)
+    {
+      if ((mask & (1 << lane)) != 0) m_overlaps.push_back((uint32_t) (index + lane));
+    }
+  }
+#endif
+
+  // Remaining lanes
+  for (; index < size; ++index)
+  {
+    if (overlaps(index)) m_overlaps.push_back((uint32_t) index);
+  }
+
+  return m_overlaps;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SphereBatch::overlaps(size_t index) const
+{
+  float x = m_offsetsX[index];
+  float y = m_offsetsY[index];
+  float z = m_offsetsZ[index];
+  float r = m_radiusesSums[index];
+
+  return !(x * x + y * y + z * z > r * r);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class SphereCollider;
+
+// Sphere/Sphere candidate pairs gathered per coordinate:
+// * overlaps are found with squared distances, several pairs per SIMD register
+// * full manifolds are only computed afterwards, for overlapping pairs
+class SphereBatch final
+{
+public:
+  using Pair = std::pair<SphereCollider*, SphereCollider*>;
+
+public:
+  SphereBatch();
+
+  // Buffers keep their capacity from one step to the next
+  void clear();
+  void addPair(SphereCollider* sphere1, SphereCollider* sphere2);
+
+  size_t size() const;
+  Pair getPair(size_t index) const;
+
+  // Indices of the pairs whose spheres overlap, in insertion order
+  const std::vector<uint32_t>& computeOverlaps();
+
+private:
+  bool overlaps(size_t index) const;
+
+private:
+  std::vector<Pair> m_pairs;
+
+  std::vector<float> m_offsetsX;
+  std::vector<float> m_offsetsY;
+  std::vector<float> m_offsetsZ;
+  std::vector<float> m_radiusesSums;
+
+  std::vector<uint32_t> m_overlaps;
+};
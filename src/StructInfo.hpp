@@ -4,7 +4,9 @@
 
 #include <optional>
 #include <iostream>
+#include <algorithm>
 #include <map>
+#include <vector>
 
 // Definitions
 constexpr static float h_step = 0.02f;
@@ -20,6 +22,112 @@ using CollisionManifold = std::pair<CollisionBodyData, CollisionBodyData>;
 // - Optional on Collision (inexistant means no Collision)
 using CollisionResult = std::optional<CollisionManifold>;
 
+// World-Space Axis-Aligned Bounds
+struct BoundingBox
+{
+  glm::vec3 min;
+  glm::vec3 max;
+
+  bool overlaps(const BoundingBox& other) const
+  {
+    return min.x <= other.max.x && other.min.x <= max.x &&
+           min.y <= other.max.y && other.min.y <= max.y &&
+           min.z <= other.max.z && other.min.z <= max.z;
+  }
+
+  bool overlaps(const glm::vec3& center, float radius) const
+  {
+    glm::vec3 offset = center - glm::clamp(center, min, max);
+    return glm::dot(offset, offset) <= radius * radius;
+  }
+
+  bool contains(const BoundingBox& other) const
+  {
+    return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+           other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+  }
+
+  // Slab test: entry distance along the Ray, if any before maxDistance
+  std::optional<float> intersects(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance) const
+  {
+    glm::vec3 t1 = (min - origin) * invDirection;
+    glm::vec3 t2 = (max - origin) * invDirection;
+    glm::vec3 tNear = glm::min(t1, t2);
+    glm::vec3 tFar = glm::max(t1, t2);
+
+    float enter = std::max({ tNear.x, tNear.y, tNear.z, 0.0f });
+    float exit = std::min({ tFar.x, tFar.y, tFar.z, maxDistance });
+    if (enter > exit)
+    {
+      return std::nullopt;
+    }
+
+    return enter;
+  }
+
+  BoundingBox merge(const BoundingBox& other) const
+  {
+    return BoundingBox{ glm::min(min, other.min), glm::max(max, other.max) };
+  }
+
+  BoundingBox fatten(float margin) const
+  {
+    return BoundingBox{ min - glm::vec3(margin), max + glm::vec3(margin) };
+  }
+
+  float area() const
+  {
+    glm::vec3 d = max - min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+  }
+};
+
+// Local-Space Bounding Sphere, a negative radius never culls
+struct BoundingSphere
+{
+  glm::vec3 center = glm::vec3(0.0);
+  float radius = -1.0f;
+
+  // Centered on the vertices AABB, any vertex type with a position
+  template <typename TVertex>
+  static BoundingSphere fromVertices(const std::vector<TVertex>& vertices)
+  {
+    if (vertices.empty())
+    {
+      return BoundingSphere();
+    }
+
+    glm::vec3 min = vertices[0].position, max = vertices[0].position;
+    for (const TVertex& vertex : vertices)
+    {
+      min = glm::min(min, vertex.position);
+      max = glm::max(max, vertex.position);
+    }
+
+    BoundingSphere sphere{ (min + max) * 0.5f, 0.0f };
+    for (const TVertex& vertex : vertices)
+    {
+      sphere.radius = std::max(sphere.radius, glm::length(vertex.position - sphere.center));
+    }
+
+    return sphere;
+  }
+
+  // Scaled by the largest axis, stays unbounded if it was
+  BoundingSphere toWorld(const glm::mat4& localToWorld) const
+  {
+    BoundingSphere sphere{ glm::vec3(localToWorld * glm::vec4(center, 1.0f)), radius };
+    if (radius >= 0.0f)
+    {
+      sphere.radius *= std::max({ glm::length(glm::vec3(localToWorld[0])),
+                                  glm::length(glm::vec3(localToWorld[1])),
+                                  glm::length(glm::vec3(localToWorld[2])) });
+    }
+
+    return sphere;
+  }
+};
+
 // Forward Declaration
 class Renderer;
 class CollisionManager;
@@ -27,9 +135,6 @@ class Physical;
 class RigidBody;
 class CollisionSolver;
 
-// Forward Inner Using (see. CollisionManager.hpp)
-using CurrentTargetCollisions = std::map<Physical*, CollisionManifold>;
-
 // Vertex Data Content
 struct VertexType
 {
@@ -39,10 +144,15 @@ struct VertexType
 };
 
 // Update Data
+// - simulation passes advance physics by dt, render passes draw
+// - a render only pass shows bodies at alpha between their last two steps
 struct UpdateData
 {
   glm::mat4 parentToWorld;
   glm::mat4 localToWorld;
   float dt;
   float t;
+  bool simulate = true;
+  bool render = true;
+  float alpha = 1.0f;
 };
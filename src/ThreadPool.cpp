@@ -0,0 +1,121 @@
+#include "ThreadPool.hpp"
+
+// ------------------------------------------------------------------------------------------------
+ThreadPool::ThreadPool(size_t threadCount)
+  : m_workers(0), m_task(nullptr), m_count(0), m_next(0), m_remaining(0),
+  m_active(0), m_generation(0), m_stopping(false)
+{
+  // The calling thread takes its share of every run
+  for (size_t ii = 1; ii < threadCount; ++ii)
+  {
+    m_workers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_wakeUp.notify_all();
+
+  for (std::thread& worker : m_workers)
+  {
+    worker.join();
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t ThreadPool::getThreadCount() const
+{
+  return m_workers.size() + 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::run(size_t count, const Task& task)
+{
+  if (count == 0)
+  {
+    return;
+  }
+
+  if (m_workers.empty() || count == 1)
+  {
+    for (size_t index = 0; index < count; ++index)
+    {
+      task(index);
+    }
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Late workers from the previous run must be done with its Task
+    m_done.wait(lock, [this]() { return m_active == 0; });
+
+    m_task = &task;
+    m_count = count;
+    m_next = 0;
+    m_remaining = count;
+    ++m_generation;
+  }
+  m_wakeUp.notify_all();
+
+  execute(&task, count);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [this]() { return m_remaining == 0; });
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::workerLoop()
+{
+  uint64_t generation = 0;
+
+  while (true)
+  {
+    const Task* task;
+    size_t count;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wakeUp.wait(lock, [&]() { return m_stopping || m_generation != generation; });
+
+      if (m_stopping)
+      {
+        return;
+      }
+
+      generation = m_generation;
+      task = m_task;
+      count = m_count;
+      ++m_active;
+    }
+
+    execute(task, count);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      --m_active;
+    }
+    m_done.notify_all();
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+void ThreadPool::execute(const Task* task, size_t count)
+{
+  for (size_t index = m_next++; index < count; index = m_next++)
+  {
+    (*task)(index);
+
+    if (--m_remaining == 0)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_done.notify_all();
+    }
+  }
+}
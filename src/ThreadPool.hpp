@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads sharing indexed tasks with the calling thread
+class ThreadPool final
+{
+public:
+  using Task = std::function<void(size_t index)>;
+
+public:
+  // Default uses every hardware thread, the caller included
+  ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Workers and caller
+  size_t getThreadCount() const;
+
+  // Calls task(index) for every index in [0, count), returns once all calls are done
+  void run(size_t count, const Task& task);
+
+private:
+  void workerLoop();
+  void execute(const Task* task, size_t count);
+
+private:
+  std::vector<std::thread> m_workers;
+
+  std::mutex m_mutex;
+  std::condition_variable m_wakeUp;
+  std::condition_variable m_done;
+
+  const Task* m_task;
+  size_t m_count;
+  std::atomic<size_t> m_next;
+  std::atomic<size_t> m_remaining;
+  size_t m_active;
+  uint64_t m_generation;
+  bool m_stopping;
+};
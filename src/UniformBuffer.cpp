@@ -0,0 +1,74 @@
+#include "UniformBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// ------------------------------------------------------------------------------------------------
+UniformBuffer::UniformBuffer(GLuint binding, size_t blockSize)
+  : m_binding(binding), m_handle(0),
+  m_blockSize(blockSize), m_stride(blockSize), m_capacity(0), m_region(0)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+UniformBuffer::~UniformBuffer()
+{
+  if (m_handle != 0)
+  {
+    glDeleteBuffers(1, &m_handle);
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+void UniformBuffer::upload(const void* data, size_t blockCount)
+{
+  if (blockCount == 0)
+  {
+    return;
+  }
+
+  reserve(blockCount);
+  m_region = (m_region + 1) % FrameCount;
+
+  // Aligned copy, then one upload for the whole region
+  m_staging.resize(blockCount * m_stride);
+  for (size_t block = 0; block < blockCount; ++block)
+  {
+    std::memcpy(m_staging.data() + block * m_stride, static_cast<const char*>(data) + block * m_blockSize, m_blockSize);
+  }
+
+  glBindBuffer(GL_UNIFORM_BUFFER, m_handle);
+  glBufferSubData(GL_UNIFORM_BUFFER, m_region * m_capacity * m_stride, m_staging.size(), m_staging.data());
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// ------------------------------------------------------------------------------------------------
+void UniformBuffer::bind(size_t block) const
+{
+  glBindBufferRange(GL_UNIFORM_BUFFER, m_binding, m_handle, (m_region * m_capacity + block) * m_stride, m_blockSize);
+}
+
+// ------------------------------------------------------------------------------------------------
+void UniformBuffer::reserve(size_t blockCount)
+{
+  if (m_handle == 0)
+  {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    alignment = std::max<GLint>(alignment, 1);
+    m_stride = (m_blockSize + alignment - 1) / alignment * alignment;
+
+    glGenBuffers(1, &m_handle);
+  }
+
+  if (blockCount <= m_capacity)
+  {
+    return;
+  }
+
+  // Grows geometrically, the previous content is not needed anymore
+  m_capacity = std::max(blockCount, 2 * m_capacity);
+  glBindBuffer(GL_UNIFORM_BUFFER, m_handle);
+  glBufferData(GL_UNIFORM_BUFFER, FrameCount * m_capacity * m_stride, nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
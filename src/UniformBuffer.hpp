@@ -0,0 +1,42 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <vector>
+
+// Uniform buffer object feeding one block binding point:
+// * each upload writes a new region, cycling through FrameCount regions so the GPU can still read the previous ones
+// * blocks are aligned on the driver offset alignment, any of them can be bound alone
+// * created on the first upload, must be destroyed while the OpenGL context is still alive
+class UniformBuffer final
+{
+public:
+  UniformBuffer(GLuint binding, size_t blockSize);
+  ~UniformBuffer();
+
+  UniformBuffer(const UniformBuffer&) = delete;
+  UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+  // Blocks are tightly packed in data, the buffer grows if needed
+  void upload(const void* data, size_t blockCount);
+
+  // Binds a block of the last upload
+  void bind(size_t block) const;
+
+private:
+  void reserve(size_t blockCount);
+
+private:
+  static constexpr size_t FrameCount = 3;
+
+  GLuint m_binding;
+  GLuint m_handle;
+
+  size_t m_blockSize;
+  size_t m_stride;
+  size_t m_capacity; // Blocks per region
+  size_t m_region;
+
+  std::vector<char> m_staging;
+};
@@ -0,0 +1,175 @@
+#include "HeadlessApplication.hpp"
+
+#include "broadphases/BruteForce.hpp"
+#include "broadphases/SpatialHashGrid.hpp"
+#include "broadphases/SweepAndPrune.hpp"
+#include "broadphases/DynamicTree.hpp"
+
+#include "scenes/BallpitScene.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+// Headless physics benchmark over the built-in scenes and scaled up ballpits:
+// * each scene is loaded, warmed up, then stepped for a fixed number of frames
+// * step times, broadphase pairs, narrowphase contacts and heap allocations are averaged per step
+// * results are printed as JSON on stdout
+namespace
+{
+  std::atomic<size_t> allocations(0);
+
+  struct Result
+  {
+    std::string name;
+    double meanStepTime;   // ns
+    double maxStepTime;    // ns
+    double pairs;
+    double contacts;
+    double allocations;
+    double broadphaseTime; // ns
+    double narrowphaseTime; // ns
+  };
+
+  // ----------------------------------------------------------------------------------------------
+  std::unique_ptr<Broadphase> makeBroadphase(const std::string& name)
+  {
+    std::vector<std::unique_ptr<Broadphase>> broadphases;
+    broadphases.push_back(std::make_unique<BruteForce>());
+    broadphases.push_back(std::make_unique<SpatialHashGrid>());
+    broadphases.push_back(std::make_unique<SweepAndPrune>());
+    broadphases.push_back(std::make_unique<DynamicTree>());
+
+    for (auto& broadphase : broadphases)
+    {
+      if (name == broadphase->getName())
+      {
+        return std::move(broadphase);
+      }
+    }
+
+    return nullptr;
+  }
+
+  // ----------------------------------------------------------------------------------------------
+  Result measure(HeadlessApplication& app, Scene* scene, const std::string& name, size_t warmup, size_t frames)
+  {
+    const auto& statistics = app.getRenderer()->getCollisionManager()->getStatistics();
+
+    app.load(scene);
+    for (size_t frame = 0; frame < warmup; ++frame)
+    {
+      app.step(scene);
+    }
+
+    Result result = {name, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+      size_t before = allocations.load(std::memory_order_relaxed);
+      double elapsed = 1e+6 * app.step(scene);
+      size_t after = allocations.load(std::memory_order_relaxed);
+
+      result.meanStepTime += elapsed;
+      result.maxStepTime = std::max(result.maxStepTime, elapsed);
+      result.pairs += statistics.pairs;
+      result.contacts += statistics.contacts;
+      result.allocations += after - before;
+      result.broadphaseTime += 1e+6 * statistics.broadphaseTime;
+      result.narrowphaseTime += 1e+6 * statistics.narrowphaseTime;
+    }
+    app.unload(scene);
+
+    for (double* value : { &result.meanStepTime, &result.pairs, &result.contacts, &result.allocations,
+                           &result.broadphaseTime, &result.narrowphaseTime })
+    {
+      *value /= std::max<size_t>(frames, 1);
+    }
+
+    return result;
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Every heap allocation of the process is counted, the benchmark itself does not allocate while stepping
+void* operator new(std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size ? size : 1))
+  {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Usage: physics-benchmark [frames] [broadphase name]
+int main(int argc, const char* argv[])
+{
+  const size_t frames = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 300;
+  const size_t warmup = 10;
+
+  HeadlessApplication app;
+  auto collisionManager = app.getRenderer()->getCollisionManager();
+
+  if (argc > 2)
+  {
+    auto broadphase = makeBroadphase(argv[2]);
+    if (!broadphase)
+    {
+      std::fprintf(stderr, "Unknown broadphase '%s'\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+    collisionManager->setBroadphase(std::move(broadphase));
+  }
+
+  std::vector<Result> results;
+  for (const auto& scene : app.getScenes())
+  {
+    results.push_back(measure(app, scene.get(), scene->getName(), warmup, frames));
+  }
+
+  // Ballpits of about 20 balls per default sized cell
+  for (auto [count, scale] : { std::make_pair<size_t, size_t>(100, 2),
+                               std::make_pair<size_t, size_t>(1000, 7),
+                               std::make_pair<size_t, size_t>(10000, 22) })
+  {
+    BallpitScene scene(count, scale);
+    results.push_back(measure(app, &scene, "Ballpit" + std::to_string(count), warmup, frames));
+  }
+
+  std::printf("{\n");
+  std::printf("  \"broadphase\": \"%s\",\n", collisionManager->getBroadphase()->getName());
+  std::printf("  \"warmup\": %zu,\n", warmup);
+  std::printf("  \"frames\": %zu,\n", frames);
+  std::printf("  \"scenes\": [\n");
+  for (size_t ii = 0; ii < results.size(); ++ii)
+  {
+    const Result& result = results[ii];
+    std::printf("    {\"name\": \"%s\", \"nsPerStep\": %.0f, \"maxNsPerStep\": %.0f, "
+                "\"broadphaseNsPerStep\": %.0f, \"narrowphaseNsPerStep\": %.0f, "
+                "\"broadphasePairs\": %.1f, \"narrowphaseHits\": %.1f, \"allocationsPerStep\": %.1f}%s\n",
+                result.name.c_str(), result.meanStepTime, result.maxStepTime,
+                result.broadphaseTime, result.narrowphaseTime,
+                result.pairs, result.contacts, result.allocations,
+                (ii + 1 < results.size()) ? "," : "");
+  }
+  std::printf("  ]\n");
+  std::printf("}\n");
+
+  return EXIT_SUCCESS;
+}
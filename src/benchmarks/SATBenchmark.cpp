@@ -0,0 +1,220 @@
+#include "SeparatingAxis.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+// OBB vs OBB Separating Axis micro-benchmark on randomized box pairs:
+// * reference: 8 AoS corners projected one glm::dot at a time
+// * kernel: SeparatingAxis batched projections
+// * both run the same axis loop, once stopping on the first separating axis and once testing all 15
+namespace
+{
+  using Vertices = std::vector<glm::vec3>;
+
+  struct Box
+  {
+    glm::mat4 transform;
+    glm::vec3 halfExtents;
+    Vertices vertices;
+    SeparatingAxis::Corners corners;
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  // ----------------------------------------------------------------------------------------------
+  SeparatingAxis::Interval referenceProject(const glm::vec3& axis, const Vertices& V)
+  {
+    float proj = glm::dot(axis, V[0]);
+    SeparatingAxis::Interval result = std::make_pair(proj, proj);
+
+    for (size_t ii = 1; ii < V.size(); ++ii)
+    {
+      proj = glm::dot(axis, V[ii]);
+      if (proj > result.second) result.second = proj;
+      else if (proj < result.first) result.first = proj;
+    }
+
+    return result;
+  }
+
+  // ----------------------------------------------------------------------------------------------
+  template <typename TProject>
+  bool isOverlapping(const glm::vec3& axis, TProject project)
+  {
+    auto [iA, iB] = project(axis);
+    return (iA.first <= iB.second) && (iB.first <= iA.second);
+  }
+
+  // ----------------------------------------------------------------------------------------------
+  template <typename TProject>
+  bool intersects(const Box& A, const Box& B, TProject project, bool earlyExit)
+  {
+    bool result = true;
+
+    auto test = [&](const glm::vec3& axis) -> bool
+    {
+      result = isOverlapping(axis, project) && result;
+      return earlyExit && !result;
+    };
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+      if (test(glm::vec3(A.transform[i]))) return false;
+    }
+    for (size_t j = 0; j < 3; ++j)
+    {
+      if (test(glm::vec3(B.transform[j]))) return false;
+    }
+    for (size_t i = 0; i < 3; ++i)
+    {
+      for (size_t j = 0; j < 3; ++j)
+      {
+        if (test(glm::cross(glm::vec3(A.transform[i]), glm::vec3(B.transform[j])))) return false;
+      }
+    }
+
+    return result;
+  }
+
+  // ----------------------------------------------------------------------------------------------
+  bool referenceIntersects(const Box& A, const Box& B, bool earlyExit)
+  {
+    return intersects(A, B, [&](const glm::vec3& axis)
+                      {
+                        return std::make_pair(referenceProject(axis, A.vertices), referenceProject(axis, B.vertices));
+                      }, earlyExit);
+  }
+
+  // ----------------------------------------------------------------------------------------------
+  bool kernelIntersects(const Box& A, const Box& B, bool earlyExit)
+  {
+    return intersects(A, B, [&](const glm::vec3& axis)
+                      {
+                        return std::make_pair(SeparatingAxis::project(axis, A.corners),
+                                              SeparatingAxis::project(axis, B.corners));
+                      }, earlyExit);
+  }
+
+  // ----------------------------------------------------------------------------------------------
+  std::vector<Box> makeBoxes(size_t count, float spread)
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> size(0.2f, 1.0f);
+
+    std::vector<Box> result(0);
+    result.reserve(count);
+
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      glm::vec3 axis = glm::vec3(unit(generator), unit(generator), unit(generator));
+      if (glm::length(axis) < 1e-3f) axis = glm::vec3(0.0f, 0.0f, 1.0f);
+
+      glm::mat4 transform = glm::translate(glm::mat4(1.0f), spread * glm::vec3(unit(generator), unit(generator), unit(generator)));
+      transform = glm::rotate(transform, 3.14159f * unit(generator), glm::normalize(axis));
+
+      Box box;
+      box.transform = transform;
+      box.halfExtents = glm::vec3(size(generator), size(generator), size(generator));
+      box.corners = SeparatingAxis::makeCorners(box.transform, box.halfExtents);
+
+      for (size_t jj = 0; jj < 8; ++jj)
+      {
+        box.vertices.push_back(glm::vec3(box.corners.x[jj], box.corners.y[jj], box.corners.z[jj]));
+      }
+
+      result.push_back(box);
+    }
+
+    return result;
+  }
+
+  // ----------------------------------------------------------------------------------------------
+  template <typename TTest>
+  double measure(const std::vector<Box>& boxes, size_t rounds, size_t& hits, TTest test)
+  {
+    hits = 0;
+    auto start = Clock::now();
+
+    for (size_t round = 0; round < rounds; ++round)
+    {
+      for (size_t ii = 0; ii + 1 < boxes.size(); ii += 2)
+      {
+        hits += test(boxes[ii], boxes[ii + 1]) ? 1 : 0;
+      }
+    }
+
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / (double) (rounds * (boxes.size() / 2));
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+  const size_t count = 2 * 4096;
+  const size_t rounds = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200;
+
+#if defined(__AVX__)
+  const char* path = "AVX";
+#elif defined(SEPARATING_AXIS_SSE)
+  const char* path = "SSE";
+#else
+  const char* path = "scalar";
+#endif
+
+  std::printf("SAT kernel: %s, %zu pairs x %zu rounds\n", path, count / 2, rounds);
+
+  // Spreads giving mostly separated, mixed and mostly overlapping pairs
+  for (float spread : { 4.0f, 1.5f, 0.5f })
+  {
+    std::vector<Box> boxes = makeBoxes(count, spread);
+
+    // Both projections must agree on every axis
+    size_t mismatches = 0;
+    for (size_t ii = 0; ii + 1 < boxes.size(); ii += 2)
+    {
+      const Box& A = boxes[ii];
+      const Box& B = boxes[ii + 1];
+
+      intersects(A, B, [&](const glm::vec3& axis)
+                 {
+                   if (referenceProject(axis, A.vertices) != SeparatingAxis::project(axis, A.corners) ||
+                       referenceProject(axis, B.vertices) != SeparatingAxis::project(axis, B.corners))
+                   {
+                     ++mismatches;
+                   }
+                   return std::make_pair(SeparatingAxis::project(axis, A.corners), SeparatingAxis::project(axis, B.corners));
+                 }, false);
+    }
+
+    std::printf("spread %.1f: mismatches %zu\n", spread, mismatches);
+
+    // Only the projection differs between both columns of a row
+    for (bool earlyExit : { true, false })
+    {
+      size_t referenceHits, kernelHits;
+      double reference = measure(boxes, rounds, referenceHits, [earlyExit](const Box& A, const Box& B)
+                                 {
+                                   return referenceIntersects(A, B, earlyExit);
+                                 });
+      double kernel = measure(boxes, rounds, kernelHits, [earlyExit](const Box& A, const Box& B)
+                              {
+                                return kernelIntersects(A, B, earlyExit);
+                              });
+
+      std::printf("  %-10s overlap %5.1f%% | reference %7.1f ns/pair | kernel %7.1f ns/pair | x%.2f%s\n",
+                  earlyExit ? "early exit" : "full scan", 100.0 * kernelHits / (double) (rounds * (count / 2)),
+                  reference, kernel, reference / kernel, referenceHits != kernelHits ? " | hits differ" : "");
+    }
+  }
+
+  return 0;
+}
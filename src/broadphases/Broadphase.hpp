@@ -0,0 +1,46 @@
+#pragma once
+
+#include "StructInfo.hpp"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Broadphase interface:
+// * tracks the World bounds of every registered Physical
+// * provides the potentially colliding pairs of a step
+// * answers spatial queries against the bounds of the last computed step
+class Broadphase
+{
+public:
+  // First element is always the earliest added Physical
+  using Pair = std::pair<Physical*, Physical*>;
+  using Pairs = std::vector<Pair>;
+  using Physicals = std::vector<Physical*>;
+
+  struct RayHit
+  {
+    Physical* physical;
+    float distance;
+  };
+
+public:
+  virtual ~Broadphase() = default;
+
+  virtual const char* getName() const = 0;
+
+  virtual bool addPhysical(Physical* physical) = 0;
+  virtual bool removePhysical(Physical* physical) = 0;
+  virtual void clearAll() = 0;
+
+  virtual const Pairs& computePairs() = 0;
+
+public:
+  virtual Physicals queryBounds(const BoundingBox& bounds) const = 0;
+  virtual Physicals querySphere(const glm::vec3& center, float radius) const = 0;
+  virtual std::optional<RayHit> rayCast(const glm::vec3& origin, const glm::vec3& direction,
+                                        float maxDistance) const = 0;
+
+protected:
+  Broadphase() = default;
+};
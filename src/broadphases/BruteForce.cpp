@@ -0,0 +1,121 @@
+#include "BruteForce.hpp"
+
+#include "components/Physical.hpp"
+
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+BruteForce::BruteForce()
+  : m_physicals(0), m_bounds(0), m_pairs(0)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+const char* BruteForce::getName() const
+{
+  return "Brute Force";
+}
+
+// ------------------------------------------------------------------------------------------------
+bool BruteForce::addPhysical(Physical* physical)
+{
+  if (physical == nullptr)
+  {
+    return false;
+  }
+
+  auto it = std::find(m_physicals.begin(), m_physicals.end(), physical);
+  if (it != m_physicals.end())
+  {
+    return false;
+  }
+
+  m_physicals.push_back(physical);
+
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool BruteForce::removePhysical(Physical* physical)
+{
+  return std::erase(m_physicals, physical) > 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void BruteForce::clearAll()
+{
+  m_physicals.clear();
+  m_bounds.clear();
+  m_pairs.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+const BruteForce::Pairs& BruteForce::computePairs()
+{
+  m_pairs.clear();
+
+  m_bounds.clear();
+  for (Physical* physical : m_physicals)
+  {
+    m_bounds.push_back(physical->computeWorldBounds());
+  }
+
+  size_t size = m_physicals.size();
+  for (size_t ii = 0; ii < size; ++ii)
+  {
+    for (size_t jj = ii + 1; jj < size; ++jj)
+    {
+      if (!m_bounds[ii].overlaps(m_bounds[jj]))
+      {
+        continue;
+      }
+
+      m_pairs.push_back(std::make_pair(m_physicals[ii], m_physicals[jj]));
+    }
+  }
+
+  return m_pairs;
+}
+
+// ------------------------------------------------------------------------------------------------
+Broadphase::Physicals BruteForce::queryBounds(const BoundingBox& bounds) const
+{
+  Physicals result(0);
+
+  std::copy_if(m_physicals.begin(), m_physicals.end(), std::back_inserter(result),
+               [&](Physical* physical) { return physical->computeWorldBounds().overlaps(bounds); });
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+Broadphase::Physicals BruteForce::querySphere(const glm::vec3& center, float radius) const
+{
+  Physicals result(0);
+
+  std::copy_if(m_physicals.begin(), m_physicals.end(), std::back_inserter(result),
+               [&](Physical* physical) { return physical->computeWorldBounds().overlaps(center, radius); });
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+std::optional<Broadphase::RayHit> BruteForce::rayCast(const glm::vec3& origin, const glm::vec3& direction,
+                                                      float maxDistance) const
+{
+  std::optional<RayHit> result = std::nullopt;
+
+  for (Physical* physical : m_physicals)
+  {
+    auto distance = physical->rayCast(origin, direction, maxDistance);
+    if (!distance.has_value())
+    {
+      continue;
+    }
+
+    maxDistance = *distance;
+    result = RayHit{ physical, *distance };
+  }
+
+  return result;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Broadphase.hpp"
+
+// Reference Broadphase: every pair of registered Physicals is tested, overlapping World bounds are candidates
+class BruteForce final : public Broadphase
+{
+public:
+  BruteForce();
+
+  const char* getName() const override;
+
+  bool addPhysical(Physical* physical) override;
+  bool removePhysical(Physical* physical) override;
+  void clearAll() override;
+
+  const Pairs& computePairs() override;
+
+public:
+  Physicals queryBounds(const BoundingBox& bounds) const override;
+  Physicals querySphere(const glm::vec3& center, float radius) const override;
+  std::optional<RayHit> rayCast(const glm::vec3& origin, const glm::vec3& direction,
+                                float maxDistance) const override;
+
+private:
+  Physicals m_physicals;
+  std::vector<BoundingBox> m_bounds; // Of the last computePairs, per Physical
+  Pairs m_pairs;
+};
@@ -0,0 +1,489 @@
+#include "DynamicTree.hpp"
+
+#include "components/Physical.hpp"
+
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+DynamicTree::DynamicTree(float margin)
+  : m_margin(margin), m_nodes(0), m_root(Null), m_freeList(Null),
+  m_proxies(0), m_pairs(0)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+const char* DynamicTree::getName() const
+{
+  return "Dynamic AABB Tree";
+}
+
+// ------------------------------------------------------------------------------------------------
+bool DynamicTree::addPhysical(Physical* physical)
+{
+  if (physical == nullptr)
+  {
+    return false;
+  }
+
+  auto it = std::find_if(m_proxies.begin(), m_proxies.end(),
+                         [&](const Proxy& proxy) { return proxy.physical == physical; });
+  if (it != m_proxies.end())
+  {
+    return false;
+  }
+
+  BoundingBox bounds = physical->computeWorldBounds();
+
+  int leaf = allocateNode();
+  m_nodes[leaf].bounds = bounds.fatten(m_margin);
+  m_nodes[leaf].proxy = (int) m_proxies.size();
+  m_nodes[leaf].height = 0;
+
+  m_proxies.push_back(Proxy{ physical, bounds, leaf });
+  insertLeaf(leaf);
+
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool DynamicTree::removePhysical(Physical* physical)
+{
+  auto it = std::find_if(m_proxies.begin(), m_proxies.end(),
+                         [&](const Proxy& proxy) { return proxy.physical == physical; });
+  if (physical == nullptr || it == m_proxies.end())
+  {
+    return false;
+  }
+
+  removeLeaf(it->leaf);
+  freeNode(it->leaf);
+
+  // Keep insertion order so pairs stay ordered by registration
+  it = m_proxies.erase(it);
+  for (; it != m_proxies.end(); ++it)
+  {
+    m_nodes[it->leaf].proxy--;
+  }
+
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void DynamicTree::clearAll()
+{
+  m_nodes.clear();
+  m_root = Null;
+  m_freeList = Null;
+
+  m_proxies.clear();
+  m_pairs.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+const DynamicTree::Pairs& DynamicTree::computePairs()
+{
+  m_pairs.clear();
+
+  // Refit: only reinsert leaves whose body moved out of its fat bounds
+  // - bodies move during the traversal without notifying the Broadphase, this is the first point of
+  //   the step where their World bounds are final
+  for (auto& proxy : m_proxies)
+  {
+    proxy.bounds = proxy.physical->computeWorldBounds();
+    if (m_nodes[proxy.leaf].bounds.contains(proxy.bounds))
+    {
+      continue;
+    }
+
+    removeLeaf(proxy.leaf);
+    m_nodes[proxy.leaf].bounds = proxy.bounds.fatten(m_margin);
+    insertLeaf(proxy.leaf);
+  }
+
+  // Each pair is reported once, by its earliest added Physical
+  for (int ii = 0; ii < (int) m_proxies.size(); ++ii)
+  {
+    const Proxy& proxy = m_proxies[ii];
+
+    query([&](const BoundingBox& bounds) { return bounds.overlaps(proxy.bounds); },
+          [&](int jj)
+          {
+            if (jj > ii && proxy.bounds.overlaps(m_proxies[jj].bounds))
+            {
+              m_pairs.push_back(std::make_pair(proxy.physical, m_proxies[jj].physical));
+            }
+          });
+  }
+
+  return m_pairs;
+}
+
+// ------------------------------------------------------------------------------------------------
+int DynamicTree::getHeight() const
+{
+  return (m_root == Null) ? 0 : m_nodes[m_root].height;
+}
+
+// ------------------------------------------------------------------------------------------------
+Broadphase::Physicals DynamicTree::queryBounds(const BoundingBox& bounds) const
+{
+  Physicals result(0);
+
+  query([&](const BoundingBox& node) { return node.overlaps(bounds); },
+        [&](int proxy)
+        {
+          if (m_proxies[proxy].bounds.overlaps(bounds)) result.push_back(m_proxies[proxy].physical);
+        });
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+Broadphase::Physicals DynamicTree::querySphere(const glm::vec3& center, float radius) const
+{
+  Physicals result(0);
+
+  query([&](const BoundingBox& node) { return node.overlaps(center, radius); },
+        [&](int proxy)
+        {
+          if (m_proxies[proxy].bounds.overlaps(center, radius)) result.push_back(m_proxies[proxy].physical);
+        });
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+std::optional<Broadphase::RayHit> DynamicTree::rayCast(const glm::vec3& origin, const glm::vec3& direction,
+                                                       float maxDistance) const
+{
+  std::optional<RayHit> result = std::nullopt;
+  glm::vec3 invDirection = 1.0f / direction;
+
+  // Closest hit so far shortens the Ray, pruning farther branches
+  query([&](const BoundingBox& node) { return node.intersects(origin, invDirection, maxDistance).has_value(); },
+        [&](int proxy)
+        {
+          Physical* physical = m_proxies[proxy].physical;
+
+          auto distance = physical->rayCast(origin, direction, maxDistance);
+          if (distance.has_value())
+          {
+            maxDistance = *distance;
+            result = RayHit{ physical, *distance };
+          }
+        });
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+int DynamicTree::allocateNode()
+{
+  int index;
+  if (m_freeList == Null)
+  {
+    index = (int) m_nodes.size();
+    m_nodes.push_back(Node{ });
+  }
+  else
+  {
+    index = m_freeList;
+    m_freeList = m_nodes[index].parent;
+  }
+
+  Node& node = m_nodes[index];
+  node.proxy = Null;
+  node.parent = Null;
+  node.child1 = Null;
+  node.child2 = Null;
+  node.height = 0;
+
+  return index;
+}
+
+// ------------------------------------------------------------------------------------------------
+void DynamicTree::freeNode(int index)
+{
+  m_nodes[index].parent = m_freeList;
+  m_nodes[index].height = -1;
+  m_freeList = index;
+}
+
+// ------------------------------------------------------------------------------------------------
+void DynamicTree::insertLeaf(int leaf)
+{
+  if (m_root == Null)
+  {
+    m_root = leaf;
+    m_nodes[m_root].parent = Null;
+    return;
+  }
+
+  // Find the best Sibling (Surface Area Heuristic)
+  BoundingBox leafBounds = m_nodes[leaf].bounds;
+
+  int index = m_root;
+  while (!m_nodes[index].isLeaf())
+  {
+    const Node& node = m_nodes[index];
+
+    float area = node.bounds.area();
+    float combinedArea = node.bounds.merge(leafBounds).area();
+
+    // Cost of creating a new Parent for this Node and the Leaf
+    float cost = 2.0f * combinedArea;
+
+    // Minimum cost of pushing the Leaf further down the Tree
+    float inheritanceCost = 2.0f * (combinedArea - area);
+
+    auto descendCost = [&](int child)
+    {
+      const Node& childNode = m_nodes[child];
+      float merged = childNode.bounds.merge(leafBounds).area();
+
+      return childNode.isLeaf()
+        ? merged + inheritanceCost
+        : merged - childNode.bounds.area() + inheritanceCost;
+    };
+
+    float cost1 = descendCost(node.child1);
+    float cost2 = descendCost(node.child2);
+
+    if (cost < cost1 && cost < cost2)
+    {
+      break;
+    }
+
+    index = (cost1 < cost2) ? node.child1 : node.child2;
+  }
+
+  int sibling = index;
+
+  // Create a new Parent
+  int oldParent = m_nodes[sibling].parent;
+  int newParent = allocateNode();
+  m_nodes[newParent].parent = oldParent;
+  m_nodes[newParent].bounds = m_nodes[sibling].bounds.merge(leafBounds);
+  m_nodes[newParent].height = m_nodes[sibling].height + 1;
+  m_nodes[newParent].child1 = sibling;
+  m_nodes[newParent].child2 = leaf;
+
+  m_nodes[sibling].parent = newParent;
+  m_nodes[leaf].parent = newParent;
+
+  if (oldParent == Null)
+  {
+    m_root = newParent;
+  }
+  else if (m_nodes[oldParent].child1 == sibling)
+  {
+    m_nodes[oldParent].child1 = newParent;
+  }
+  else
+  {
+    m_nodes[oldParent].child2 = newParent;
+  }
+
+  refit(m_nodes[leaf].parent);
+}
+
+// ------------------------------------------------------------------------------------------------
+void DynamicTree::removeLeaf(int leaf)
+{
+  if (leaf == m_root)
+  {
+    m_root = Null;
+    return;
+  }
+
+  int parent = m_nodes[leaf].parent;
+  int grandParent = m_nodes[parent].parent;
+  int sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+  freeNode(parent);
+
+  if (grandParent == Null)
+  {
+    m_root = sibling;
+    m_nodes[sibling].parent = Null;
+    return;
+  }
+
+  // Replace the Parent by the Sibling
+  if (m_nodes[grandParent].child1 == parent) m_nodes[grandParent].child1 = sibling;
+  else m_nodes[grandParent].child2 = sibling;
+  m_nodes[sibling].parent = grandParent;
+
+  refit(grandParent);
+}
+
+// ------------------------------------------------------------------------------------------------
+void DynamicTree::refit(int index)
+{
+  while (index != Null)
+  {
+    index = balance(index);
+
+    Node& node = m_nodes[index];
+    const Node& child1 = m_nodes[node.child1];
+    const Node& child2 = m_nodes[node.child2];
+
+    node.height = 1 + std::max(child1.height, child2.height);
+    node.bounds = child1.bounds.merge(child2.bounds);
+
+    index = node.parent;
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+int DynamicTree::balance(int iA)
+{
+  Node& A = m_nodes[iA];
+  if (A.isLeaf() || A.height < 2)
+  {
+    return iA;
+  }
+
+  int iB = A.child1;
+  int iC = A.child2;
+  Node& B = m_nodes[iB];
+  Node& C = m_nodes[iC];
+
+  // Put the 'up' Node in place of A
+  auto replaceInParent = [&](int up)
+  {
+    int parent = m_nodes[up].parent;
+    if (parent == Null) m_root = up;
+    else if (m_nodes[parent].child1 == iA) m_nodes[parent].child1 = up;
+    else m_nodes[parent].child2 = up;
+  };
+
+  int balance = C.height - B.height;
+
+  // Rotate C up
+  if (balance > 1)
+  {
+    int iF = C.child1;
+    int iG = C.child2;
+    Node& F = m_nodes[iF];
+    Node& G = m_nodes[iG];
+
+    C.child1 = iA;
+    C.parent = A.parent;
+    A.parent = iC;
+    replaceInParent(iC);
+
+    if (F.height > G.height)
+    {
+      C.child2 = iF;
+      A.child2 = iG;
+      G.parent = iA;
+      A.bounds = B.bounds.merge(G.bounds);
+      C.bounds = A.bounds.merge(F.bounds);
+      A.height = 1 + std::max(B.height, G.height);
+      C.height = 1 + std::max(A.height, F.height);
+    }
+    else
+    {
+      C.child2 = iG;
+      A.child2 = iF;
+      F.parent = iA;
+      A.bounds = B.bounds.merge(F.bounds);
+      C.bounds = A.bounds.merge(G.bounds);
+      A.height = 1 + std::max(B.height, F.height);
+      C.height = 1 + std::max(A.height, G.height);
+    }
+
+    return iC;
+  }
+
+  // Rotate B up
+  if (balance < -1)
+  {
+    int iD = B.child1;
+    int iE = B.child2;
+    Node& D = m_nodes[iD];
+    Node& E = m_nodes[iE];
+
+    B.child1 = iA;
+    B.parent = A.parent;
+    A.parent = iB;
+    replaceInParent(iB);
+
+    if (D.height > E.height)
+    {
+      B.child2 = iD;
+      A.child1 = iE;
+      E.parent = iA;
+      A.bounds = C.bounds.merge(E.bounds);
+      B.bounds = A.bounds.merge(D.bounds);
+      A.height = 1 + std::max(C.height, E.height);
+      B.height = 1 + std::max(A.height, D.height);
+    }
+    else
+    {
+      B.child2 = iE;
+      A.child1 = iD;
+      D.parent = iA;
+      A.bounds = C.bounds.merge(D.bounds);
+      B.bounds = A.bounds.merge(E.bounds);
+      A.height = 1 + std::max(C.height, D.height);
+      B.height = 1 + std::max(A.height, E.height);
+    }
+
+    return iB;
+  }
+
+  return iA;
+}
+
+// ------------------------------------------------------------------------------------------------
+template <typename TOverlap, typename TVisit>
+void DynamicTree::query(TOverlap overlap, TVisit visit) const
+{
+  if (m_root == Null)
+  {
+    return;
+  }
+
+  int inlineStack[QueryStackSize];
+  std::vector<int> heapStack(0);
+  int* stack = inlineStack;
+  size_t capacity = QueryStackSize;
+  size_t count = 0;
+
+  auto push = [&](int index)
+  {
+    if (count == capacity)
+    {
+      if (heapStack.empty()) heapStack.assign(inlineStack, inlineStack + count);
+      heapStack.resize(2 * capacity);
+      stack = heapStack.data();
+      capacity = heapStack.size();
+    }
+
+    stack[count++] = index;
+  };
+
+  push(m_root);
+
+  while (count > 0)
+  {
+    int index = stack[--count];
+
+    const Node& node = m_nodes[index];
+    if (!overlap(node.bounds))
+    {
+      continue;
+    }
+
+    if (node.isLeaf())
+    {
+      visit(node.proxy);
+      continue;
+    }
+
+    push(node.child1);
+    push(node.child2);
+  }
+}
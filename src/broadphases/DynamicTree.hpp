@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Broadphase.hpp"
+
+// Dynamic AABB Tree (BVH):
+// * each Physical is a leaf holding its World bounds fattened by a margin
+// * leaves are only reinserted once their tight bounds escape the fat ones
+// * bodies do not notify the Broadphase when they move, leaves are refit at the start of computePairs
+// * queries keep their traversal stack local, they may run concurrently or from a query visitor
+// * insertion follows the surface area heuristic, kept balanced with rotations
+class DynamicTree final : public Broadphase
+{
+public:
+  DynamicTree(float margin = 0.1f);
+
+  const char* getName() const override;
+
+  bool addPhysical(Physical* physical) override;
+  bool removePhysical(Physical* physical) override;
+  void clearAll() override;
+
+  const Pairs& computePairs() override;
+
+  int getHeight() const;
+
+public:
+  Physicals queryBounds(const BoundingBox& bounds) const override;
+  Physicals querySphere(const glm::vec3& center, float radius) const override;
+  std::optional<RayHit> rayCast(const glm::vec3& origin, const glm::vec3& direction,
+                                float maxDistance) const override;
+
+private:
+  static constexpr int Null = -1;
+
+  // Traversal stack kept on the call stack, deeper trees fall back on the heap
+  static constexpr size_t QueryStackSize = 64;
+
+  struct Node
+  {
+    BoundingBox bounds;
+    int proxy; // Leaf only
+    int parent; // Next free Node once released
+    int child1;
+    int child2;
+    int height; // Leaf: 0 - Free: -1
+
+    bool isLeaf() const { return child1 == Null; }
+  };
+
+  struct Proxy
+  {
+    Physical* physical;
+    BoundingBox bounds;
+    int leaf;
+  };
+
+private:
+  int allocateNode();
+  void freeNode(int index);
+
+  void insertLeaf(int leaf);
+  void removeLeaf(int leaf);
+  void refit(int index);
+  int balance(int index);
+
+  template <typename TOverlap, typename TVisit>
+  void query(TOverlap overlap, TVisit visit) const;
+
+private:
+  float m_margin;
+
+  std::vector<Node> m_nodes;
+  int m_root;
+  int m_freeList;
+
+  std::vector<Proxy> m_proxies;
+  Pairs m_pairs;
+};
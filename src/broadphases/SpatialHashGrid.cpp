@@ -0,0 +1,292 @@
+#include "SpatialHashGrid.hpp"
+
+#include "components/Physical.hpp"
+#include "components/SphereCollider.hpp"
+
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+SpatialHashGrid::SpatialHashGrid()
+  : m_cellSize(1.0f), m_needsCellSize(false),
+  m_proxies(0), m_oversized(0), m_cells(), m_occupiedCells(0), m_pairs(0)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+const char* SpatialHashGrid::getName() const
+{
+  return "Spatial Hash Grid";
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SpatialHashGrid::addPhysical(Physical* physical)
+{
+  if (physical == nullptr)
+  {
+    return false;
+  }
+
+  auto it = std::find_if(m_proxies.begin(), m_proxies.end(),
+                         [&](const Proxy& proxy) { return proxy.physical == physical; });
+  if (it != m_proxies.end())
+  {
+    return false;
+  }
+
+  m_proxies.push_back(Proxy{ physical, physical->computeWorldBounds(), false });
+  m_needsCellSize = true;
+
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SpatialHashGrid::removePhysical(Physical* physical)
+{
+  auto it = std::find_if(m_proxies.begin(), m_proxies.end(),
+                         [&](const Proxy& proxy) { return proxy.physical == physical; });
+  if (physical == nullptr || it == m_proxies.end())
+  {
+    return false;
+  }
+
+  // Keep insertion order so pairs stay ordered by registration
+  m_proxies.erase(it);
+  m_needsCellSize = true;
+
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialHashGrid::clearAll()
+{
+  m_proxies.clear();
+  m_oversized.clear();
+  m_cells.clear();
+  m_occupiedCells.clear();
+  m_pairs.clear();
+
+  m_needsCellSize = false;
+}
+
+// ------------------------------------------------------------------------------------------------
+const SpatialHashGrid::Pairs& SpatialHashGrid::computePairs()
+{
+  m_pairs.clear();
+  m_oversized.clear();
+
+  // Cells left empty by the last step are dropped once they are the majority
+  if (m_cells.size() > 2 * m_occupiedCells.size())
+  {
+    std::erase_if(m_cells, [](const auto& cell) { return cell.second.empty(); });
+  }
+
+  for (auto& [key, cell] : m_occupiedCells)
+  {
+    cell->clear();
+  }
+  m_occupiedCells.clear();
+
+  if (m_needsCellSize)
+  {
+    updateCellSize();
+  }
+
+  // Rasterize every Proxy in its covered cells
+  for (uint32_t ii = 0; ii < (uint32_t) m_proxies.size(); ++ii)
+  {
+    Proxy& proxy = m_proxies[ii];
+    proxy.bounds = proxy.physical->computeWorldBounds();
+
+    glm::ivec3 lower = toCell(proxy.bounds.min);
+    glm::ivec3 upper = toCell(proxy.bounds.max);
+
+    int64_t cellCount = (int64_t) (upper.x - lower.x + 1) * (upper.y - lower.y + 1) * (upper.z - lower.z + 1);
+    proxy.isOversized = (cellCount > MaxCellsPerProxy);
+
+    if (proxy.isOversized)
+    {
+      m_oversized.push_back(ii);
+      continue;
+    }
+
+    for (int z = lower.z; z <= upper.z; ++z)
+    {
+      for (int y = lower.y; y <= upper.y; ++y)
+      {
+        for (int x = lower.x; x <= upper.x; ++x)
+        {
+          uint64_t key = toKey(glm::ivec3(x, y, z));
+
+          Cell& cell = m_cells[key];
+          if (cell.empty()) m_occupiedCells.push_back(std::make_pair(key, &cell));
+          cell.push_back(ii);
+        }
+      }
+    }
+  }
+
+  // Proxies are ordered inside a cell, they were added by increasing index
+  for (const auto& [key, cell] : m_occupiedCells)
+  {
+    const size_t size = cell->size();
+    for (size_t ii = 0; ii < size; ++ii)
+    {
+      const Proxy& proxyA = m_proxies[(*cell)[ii]];
+
+      for (size_t jj = ii + 1; jj < size; ++jj)
+      {
+        const Proxy& proxyB = m_proxies[(*cell)[jj]];
+        if (!proxyA.bounds.overlaps(proxyB.bounds))
+        {
+          continue;
+        }
+
+        // Pairs sharing several cells are only reported once
+        glm::vec3 corner = glm::max(proxyA.bounds.min, proxyB.bounds.min);
+        if (toKey(toCell(corner)) != key)
+        {
+          continue;
+        }
+
+        m_pairs.push_back(std::make_pair(proxyA.physical, proxyB.physical));
+      }
+    }
+  }
+
+  // Oversized Proxies against everything
+  for (uint32_t large : m_oversized)
+  {
+    const Proxy& proxyA = m_proxies[large];
+
+    for (uint32_t ii = 0; ii < (uint32_t) m_proxies.size(); ++ii)
+    {
+      const Proxy& proxyB = m_proxies[ii];
+      if (ii == large || (proxyB.isOversized && ii < large) || !proxyA.bounds.overlaps(proxyB.bounds))
+      {
+        continue;
+      }
+
+      m_pairs.push_back((ii < large)
+        ? std::make_pair(proxyB.physical, proxyA.physical)
+        : std::make_pair(proxyA.physical, proxyB.physical));
+    }
+  }
+
+  return m_pairs;
+}
+
+// ------------------------------------------------------------------------------------------------
+float SpatialHashGrid::getCellSize() const
+{
+  return m_cellSize;
+}
+
+// ------------------------------------------------------------------------------------------------
+Broadphase::Physicals SpatialHashGrid::queryBounds(const BoundingBox& bounds) const
+{
+  Physicals result(0);
+
+  for (const auto& proxy : m_proxies)
+  {
+    if (proxy.bounds.overlaps(bounds)) result.push_back(proxy.physical);
+  }
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+Broadphase::Physicals SpatialHashGrid::querySphere(const glm::vec3& center, float radius) const
+{
+  Physicals result(0);
+
+  for (const auto& proxy : m_proxies)
+  {
+    if (proxy.bounds.overlaps(center, radius)) result.push_back(proxy.physical);
+  }
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+std::optional<Broadphase::RayHit> SpatialHashGrid::rayCast(const glm::vec3& origin, const glm::vec3& direction,
+                                                           float maxDistance) const
+{
+  std::optional<RayHit> result = std::nullopt;
+  glm::vec3 invDirection = 1.0f / direction;
+
+  for (const auto& proxy : m_proxies)
+  {
+    if (!proxy.bounds.intersects(origin, invDirection, maxDistance).has_value())
+    {
+      continue;
+    }
+
+    auto distance = proxy.physical->rayCast(origin, direction, maxDistance);
+    if (!distance.has_value())
+    {
+      continue;
+    }
+
+    maxDistance = *distance;
+    result = RayHit{ proxy.physical, *distance };
+  }
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialHashGrid::updateCellSize()
+{
+  m_needsCellSize = false;
+
+  std::vector<float> radiuses(0);
+  for (const auto& proxy : m_proxies)
+  {
+    if (auto sphere = dynamic_cast<SphereCollider*>(proxy.physical))
+    {
+      radiuses.push_back(sphere->getRadius());
+    }
+  }
+
+  // Without Spheres, fall back on the largest half extent of each bounds
+  if (radiuses.empty())
+  {
+    for (const auto& proxy : m_proxies)
+    {
+      glm::vec3 extent = (proxy.bounds.max - proxy.bounds.min) * 0.5f;
+      radiuses.push_back(std::max({ extent.x, extent.y, extent.z }));
+    }
+  }
+
+  if (radiuses.empty())
+  {
+    return;
+  }
+
+  auto median = radiuses.begin() + radiuses.size() / 2;
+  std::nth_element(radiuses.begin(), median, radiuses.end());
+
+  // One cell per median diameter
+  if (*median > 0.0f)
+  {
+    m_cellSize = 2.0f * (*median);
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+glm::ivec3 SpatialHashGrid::toCell(const glm::vec3& position) const
+{
+  return glm::ivec3(glm::floor(position / m_cellSize));
+}
+
+// ------------------------------------------------------------------------------------------------
+uint64_t SpatialHashGrid::toKey(const glm::ivec3& cell)
+{
+  // 21 bits per axis, centered around the origin
+  constexpr uint64_t mask = (1 << 21) - 1;
+  constexpr int64_t offset = 1 << 20;
+
+  return (((uint64_t) (cell.x + offset) & mask)) |
+         (((uint64_t) (cell.y + offset) & mask) << 21) |
+         (((uint64_t) (cell.z + offset) & mask) << 42);
+}
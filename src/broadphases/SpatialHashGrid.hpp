@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Broadphase.hpp"
+
+#include <unordered_map>
+
+// Uniform Spatial Hash Grid:
+// * cell size is derived from the median SphereCollider radius
+// * each Physical is registered in every cell its World bounds cover
+// * cells are hashed on their packed coordinates, their buckets keep their capacity between steps
+// * a pair is only reported by the cell holding the corner of its bounds intersection
+// * oversized Physicals (walls, grounds) bypass the grid and are tested against all
+class SpatialHashGrid final : public Broadphase
+{
+public:
+  SpatialHashGrid();
+
+  const char* getName() const override;
+
+  bool addPhysical(Physical* physical) override;
+  bool removePhysical(Physical* physical) override;
+  void clearAll() override;
+
+  const Pairs& computePairs() override;
+
+  float getCellSize() const;
+
+public:
+  Physicals queryBounds(const BoundingBox& bounds) const override;
+  Physicals querySphere(const glm::vec3& center, float radius) const override;
+  std::optional<RayHit> rayCast(const glm::vec3& origin, const glm::vec3& direction,
+                                float maxDistance) const override;
+
+private:
+  // Proxies covering more cells are tested against every other one
+  static constexpr int64_t MaxCellsPerProxy = 64;
+
+  struct Proxy
+  {
+    Physical* physical;
+    BoundingBox bounds;
+    bool isOversized;
+  };
+
+  // Proxies of a cell, in registration order
+  using Cell = std::vector<uint32_t>;
+
+private:
+  void updateCellSize();
+  glm::ivec3 toCell(const glm::vec3& position) const;
+
+  static uint64_t toKey(const glm::ivec3& cell);
+
+private:
+  float m_cellSize;
+  bool m_needsCellSize;
+
+  std::vector<Proxy> m_proxies;
+  std::vector<uint32_t> m_oversized;
+  std::unordered_map<uint64_t, Cell> m_cells;
+  std::vector<std::pair<uint64_t, Cell*>> m_occupiedCells; // Of the current step, in first filled order
+  Pairs m_pairs;
+};
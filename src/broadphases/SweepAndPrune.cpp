@@ -0,0 +1,252 @@
+#include "SweepAndPrune.hpp"
+
+#include "components/Physical.hpp"
+
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+SweepAndPrune::SweepAndPrune()
+  : m_proxies(0), m_endpoints(0), m_sweepAxis(0), m_needsFullSort(false), m_active(0), m_pairs(0)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+const char* SweepAndPrune::getName() const
+{
+  return "Sweep and Prune";
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SweepAndPrune::addPhysical(Physical* physical)
+{
+  if (physical == nullptr)
+  {
+    return false;
+  }
+
+  auto it = std::find_if(m_proxies.begin(), m_proxies.end(),
+                         [&](const Proxy& proxy) { return proxy.physical == physical; });
+  if (it != m_proxies.end())
+  {
+    return false;
+  }
+
+  uint32_t index = (uint32_t) m_proxies.size();
+  m_proxies.push_back(Proxy{ physical, BoundingBox{ glm::vec3(0.0), glm::vec3(0.0) } });
+
+  m_endpoints.push_back(Endpoint{ 0.0f, index, true });
+  m_endpoints.push_back(Endpoint{ 0.0f, index, false });
+
+  // Bulk insertion is cheaper with a full sort than with an insertion sort
+  m_needsFullSort = true;
+
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SweepAndPrune::removePhysical(Physical* physical)
+{
+  auto it = std::find_if(m_proxies.begin(), m_proxies.end(),
+                         [&](const Proxy& proxy) { return proxy.physical == physical; });
+  if (physical == nullptr || it == m_proxies.end())
+  {
+    return false;
+  }
+
+  // Keep insertion order so pairs stay ordered by registration
+  uint32_t index = (uint32_t) std::distance(m_proxies.begin(), it);
+  m_proxies.erase(it);
+
+  std::erase_if(m_endpoints, [&](const Endpoint& ep) { return ep.proxy == index; });
+
+  for (auto& ep : m_endpoints)
+  {
+    if (ep.proxy > index) ep.proxy--;
+  }
+
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SweepAndPrune::clearAll()
+{
+  m_proxies.clear();
+  m_endpoints.clear();
+
+  m_active.clear();
+  m_pairs.clear();
+  m_needsFullSort = false;
+}
+
+// ------------------------------------------------------------------------------------------------
+const SweepAndPrune::Pairs& SweepAndPrune::computePairs()
+{
+  m_pairs.clear();
+
+  updateBounds();
+
+  // Sweep along the axis of largest spread to minimize false positives
+  size_t sweepAxis = selectSweepAxis();
+  if (sweepAxis != m_sweepAxis)
+  {
+    m_sweepAxis = sweepAxis;
+    m_needsFullSort = true;
+  }
+
+  sortEndpoints();
+  m_needsFullSort = false;
+
+  m_active.clear();
+  for (const Endpoint& ep : m_endpoints)
+  {
+    if (!ep.isMin)
+    {
+      auto it = std::find(m_active.begin(), m_active.end(), ep.proxy);
+      *it = m_active.back();
+      m_active.pop_back();
+      continue;
+    }
+
+    const Proxy& proxy = m_proxies[ep.proxy];
+    for (uint32_t other : m_active)
+    {
+      if (!proxy.bounds.overlaps(m_proxies[other].bounds))
+      {
+        continue;
+      }
+
+      m_pairs.push_back((other < ep.proxy)
+        ? std::make_pair(m_proxies[other].physical, proxy.physical)
+        : std::make_pair(proxy.physical, m_proxies[other].physical));
+    }
+
+    m_active.push_back(ep.proxy);
+  }
+
+  return m_pairs;
+}
+
+// ------------------------------------------------------------------------------------------------
+Broadphase::Physicals SweepAndPrune::queryBounds(const BoundingBox& bounds) const
+{
+  Physicals result(0);
+
+  for (const auto& proxy : m_proxies)
+  {
+    if (proxy.bounds.overlaps(bounds)) result.push_back(proxy.physical);
+  }
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+Broadphase::Physicals SweepAndPrune::querySphere(const glm::vec3& center, float radius) const
+{
+  Physicals result(0);
+
+  for (const auto& proxy : m_proxies)
+  {
+    if (proxy.bounds.overlaps(center, radius)) result.push_back(proxy.physical);
+  }
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+std::optional<Broadphase::RayHit> SweepAndPrune::rayCast(const glm::vec3& origin, const glm::vec3& direction,
+                                                         float maxDistance) const
+{
+  std::optional<RayHit> result = std::nullopt;
+  glm::vec3 invDirection = 1.0f / direction;
+
+  for (const auto& proxy : m_proxies)
+  {
+    if (!proxy.bounds.intersects(origin, invDirection, maxDistance).has_value())
+    {
+      continue;
+    }
+
+    auto distance = proxy.physical->rayCast(origin, direction, maxDistance);
+    if (!distance.has_value())
+    {
+      continue;
+    }
+
+    maxDistance = *distance;
+    result = RayHit{ proxy.physical, *distance };
+  }
+
+  return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SweepAndPrune::updateBounds()
+{
+  for (auto& proxy : m_proxies)
+  {
+    proxy.bounds = proxy.physical->computeWorldBounds();
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SweepAndPrune::sortEndpoints()
+{
+  Endpoints& endpoints = m_endpoints;
+
+  for (auto& ep : endpoints)
+  {
+    const BoundingBox& bounds = m_proxies[ep.proxy].bounds;
+    ep.value = ep.isMin ? bounds.min[m_sweepAxis] : bounds.max[m_sweepAxis];
+  }
+
+  if (m_needsFullSort)
+  {
+    std::sort(endpoints.begin(), endpoints.end(), isBefore);
+    return;
+  }
+
+  // Insertion Sort: bodies barely move between two steps
+  for (size_t ii = 1; ii < endpoints.size(); ++ii)
+  {
+    Endpoint key = endpoints[ii];
+
+    size_t jj = ii;
+    while (jj > 0 && isBefore(key, endpoints[jj - 1]))
+    {
+      endpoints[jj] = endpoints[jj - 1];
+      jj--;
+    }
+
+    endpoints[jj] = key;
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SweepAndPrune::isBefore(const Endpoint& a, const Endpoint& b)
+{
+  // Min before Max on equal values, so touching bounds are reported as overlapping
+  return (a.value < b.value) || (a.value == b.value && a.isMin && !b.isMin);
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t SweepAndPrune::selectSweepAxis() const
+{
+  if (m_proxies.empty())
+  {
+    return 0;
+  }
+
+  glm::vec3 sum(0.0f), sum2(0.0f);
+  for (const auto& proxy : m_proxies)
+  {
+    glm::vec3 center = (proxy.bounds.min + proxy.bounds.max) * 0.5f;
+    sum += center;
+    sum2 += center * center;
+  }
+
+  float n = (float) m_proxies.size();
+  glm::vec3 variance = sum2 / n - (sum / n) * (sum / n);
+
+  if (variance.x >= variance.y && variance.x >= variance.z) return 0;
+  return (variance.y >= variance.z) ? 1 : 2;
+}
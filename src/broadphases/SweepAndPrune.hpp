@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Broadphase.hpp"
+
+// Incremental Sweep-and-Prune:
+// * keeps the World AABB endpoints of every Physical sorted along the sweep axis only
+// * re-sorts them each step with an insertion sort (near linear on coherent motion)
+// * the sweep axis is the most spread one, a change of axis sorts the endpoints from scratch
+// * reports the pairs overlapping on the 3 axes only
+class SweepAndPrune final : public Broadphase
+{
+public:
+  SweepAndPrune();
+
+  const char* getName() const override;
+
+  bool addPhysical(Physical* physical) override;
+  bool removePhysical(Physical* physical) override;
+  void clearAll() override;
+
+  const Pairs& computePairs() override;
+
+public:
+  Physicals queryBounds(const BoundingBox& bounds) const override;
+  Physicals querySphere(const glm::vec3& center, float radius) const override;
+  std::optional<RayHit> rayCast(const glm::vec3& origin, const glm::vec3& direction,
+                                float maxDistance) const override;
+
+private:
+  struct Proxy
+  {
+    Physical* physical;
+    BoundingBox bounds;
+  };
+
+  struct Endpoint
+  {
+    float value;
+    uint32_t proxy;
+    bool isMin;
+  };
+
+  using Endpoints = std::vector<Endpoint>;
+
+private:
+  void updateBounds();
+  void sortEndpoints();
+  size_t selectSweepAxis() const;
+
+  static bool isBefore(const Endpoint& a, const Endpoint& b);
+
+private:
+  std::vector<Proxy> m_proxies;
+  Endpoints m_endpoints;
+  size_t m_sweepAxis;
+  bool m_needsFullSort;
+
+  std::vector<uint32_t> m_active;
+  Pairs m_pairs;
+};
@@ -13,6 +13,9 @@ public:
     std::vector<GLuint> indexes;
   };
 
+  // Finest first, each level drawn further away than the previous one
+  using LevelsOfDetail = std::vector<Result>;
+
   using ColorationMethod = std::function<glm::vec4(VertexType)>;
   inline static ColorationMethod DefaultColoration = [](VertexType)
   {
@@ -21,4 +24,10 @@ public:
 
 protected:
   virtual Result makeMeshContent(ColorationMethod) const = 0;
+
+  // A single level unless the builder can make coarser ones
+  virtual LevelsOfDetail makeLevelsOfDetail(ColorationMethod coloration) const
+  {
+    return LevelsOfDetail{ makeMeshContent(coloration) };
+  }
 };
\ No newline at end of file
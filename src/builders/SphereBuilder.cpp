@@ -1,8 +1,9 @@
+#include <algorithm>
 #include <list>
 #include "SphereBuilder.hpp"
 
-SphereBuilder::SphereBuilder(float radius)
-  : m_radius(radius)
+SphereBuilder::SphereBuilder(float radius, int subdivisions)
+  : m_radius(radius), m_subdivisions(std::max(subdivisions, 0))
   {
   }
 
@@ -11,7 +12,28 @@ SphereBuilder::SphereBuilder(float radius)
     return m_radius;
   }
 
+  int SphereBuilder::getSubdivisions() const
+  {
+    return m_subdivisions;
+  }
+
 Builder::Result SphereBuilder::makeMeshContent(ColorationMethod coloration) const
+{
+  return makeMeshContent(coloration, m_subdivisions);
+}
+
+Builder::LevelsOfDetail SphereBuilder::makeLevelsOfDetail(ColorationMethod coloration) const
+{
+  LevelsOfDetail levels;
+  for (int subdivisions = m_subdivisions; subdivisions >= 0; --subdivisions)
+  {
+    levels.push_back(makeMeshContent(coloration, subdivisions));
+  }
+
+  return levels;
+}
+
+Builder::Result SphereBuilder::makeMeshContent(ColorationMethod coloration, int subdivisions) const
 {
   Builder::Result result;
 
@@ -66,8 +88,6 @@ Builder::Result SphereBuilder::makeMeshContent(ColorationMethod coloration) cons
 
   int verticesCount = 12;
 
-  std::list<glm::vec3> subdividedIcoFaces;
-  std::list<glm::vec3> TwoTimesSubdividedIcoFaces;
   int index_0;
   int index_1;
   int index_2;
@@ -75,39 +95,30 @@ Builder::Result SphereBuilder::makeMeshContent(ColorationMethod coloration) cons
   int index_4;
   int index_5;
 
-  for (glm::vec3 face : icoFaces) {
-    index_0 = face.x;
-    index_1 = face.y;
-    index_2 = face.z;
-    result.vertices.push_back(makeVertex(glm::normalize(0.5f * (result.vertices[index_0].position + result.vertices[index_1].position)) * m_radius));
-    index_3 = verticesCount++;
-    result.vertices.push_back(makeVertex(glm::normalize(0.5f * (result.vertices[index_1].position + result.vertices[index_2].position)) * m_radius));
-    index_4 = verticesCount++;
-    result.vertices.push_back(makeVertex(glm::normalize(0.5f * (result.vertices[index_2].position + result.vertices[index_0].position)) * m_radius));
-    index_5 = verticesCount++;
-    subdividedIcoFaces.push_back(glm::vec3(index_0, index_3, index_5));
-    subdividedIcoFaces.push_back(glm::vec3(index_3, index_1, index_4));
-    subdividedIcoFaces.push_back(glm::vec3(index_5, index_4, index_2));
-    subdividedIcoFaces.push_back(glm::vec3(index_3, index_4, index_5));
-  }
+  // Each subdivision splits every face in four, on the sphere
+  for (int level = 0; level < subdivisions; ++level) {
+    std::list<glm::vec3> subdividedIcoFaces;
 
-    for (glm::vec3 face : subdividedIcoFaces) {
-    index_0 = face.x;
-    index_1 = face.y;
-    index_2 = face.z;
-    result.vertices.push_back(makeVertex(glm::normalize(0.5f * (result.vertices[index_0].position + result.vertices[index_1].position)) * m_radius));
-    index_3 = verticesCount++;
-    result.vertices.push_back(makeVertex(glm::normalize(0.5f * (result.vertices[index_1].position + result.vertices[index_2].position)) * m_radius));
-    index_4 = verticesCount++;
-    result.vertices.push_back(makeVertex(glm::normalize(0.5f * (result.vertices[index_2].position + result.vertices[index_0].position)) * m_radius));
-    index_5 = verticesCount++;
-    TwoTimesSubdividedIcoFaces.push_back(glm::vec3(index_0, index_3, index_5));
-    TwoTimesSubdividedIcoFaces.push_back(glm::vec3(index_3, index_1, index_4));
-    TwoTimesSubdividedIcoFaces.push_back(glm::vec3(index_5, index_4, index_2));
-    TwoTimesSubdividedIcoFaces.push_back(glm::vec3(index_3, index_4, index_5));
+    for (glm::vec3 face : icoFaces) {
+      index_0 = face.x;
+      index_1 = face.y;
+      index_2 = face.z;
+      result.vertices.push_back(makeVertex(glm::normalize(0.5f * (result.vertices[index_0].position + result.vertices[index_1].position)) * m_radius));
+      index_3 = verticesCount++;
+      result.vertices.push_back(makeVertex(glm::normalize(0.5f * (result.vertices[index_1].position + result.vertices[index_2].position)) * m_radius));
+      index_4 = verticesCount++;
+      result.vertices.push_back(makeVertex(glm::normalize(0.5f * (result.vertices[index_2].position + result.vertices[index_0].position)) * m_radius));
+      index_5 = verticesCount++;
+      subdividedIcoFaces.push_back(glm::vec3(index_0, index_3, index_5));
+      subdividedIcoFaces.push_back(glm::vec3(index_3, index_1, index_4));
+      subdividedIcoFaces.push_back(glm::vec3(index_5, index_4, index_2));
+      subdividedIcoFaces.push_back(glm::vec3(index_3, index_4, index_5));
+    }
+
+    icoFaces = std::move(subdividedIcoFaces);
   }
 
-  for (glm::vec3 face : TwoTimesSubdividedIcoFaces) {
+  for (glm::vec3 face : icoFaces) {
     result.indexes.push_back(face.x); result.indexes.push_back(face.y); result.indexes.push_back(face.z);
   }
 
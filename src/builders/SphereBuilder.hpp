@@ -4,15 +4,25 @@
 
 class SphereBuilder : public Builder
 {
+public:
+    // Icosahedron subdivisions of the finest level, 20 * 4^n faces
+    static constexpr int DefaultSubdivisions = 2;
+
 protected:
-    SphereBuilder(float radius);
+    SphereBuilder(float radius, int subdivisions = DefaultSubdivisions);
 
 public:
     float getRadius() const;
+    int getSubdivisions() const;
 
 protected:
     Result makeMeshContent(ColorationMethod coloration) const override;
+    Result makeMeshContent(ColorationMethod coloration, int subdivisions) const;
+
+    // One level per subdivision, down to the plain icosahedron
+    LevelsOfDetail makeLevelsOfDetail(ColorationMethod coloration) const override;
 
 protected:
     float m_radius;
+    int m_subdivisions;
 };
\ No newline at end of file
@@ -22,14 +22,16 @@ Box::Box(glm::vec3 scale)
 // ------------------------------------------------------------------------------------------------
 void Box::beforeInitialize(Renderer* renderer)
 {
-  Meshable::initializeMesh();
+  Meshable::initializeMesh(renderer);
 }
 
 // ------------------------------------------------------------------------------------------------
 void Box::beforeUpdate(Renderer* renderer, UpdateData& data)
 {
-  Meshable::updateRenderable(renderer, data.localToWorld,
-                             6 * // Face on Cube
-                             2 * // Triangle per Face
-                             3); // Values amount
+  if (!data.render)
+  {
+    return;
+  }
+
+  Meshable::updateRenderable(renderer, data.localToWorld);
 }
@@ -45,7 +45,7 @@ std::optional<std::pair<glm::vec3, glm::vec3>> getBoundsInfo(const std::shared_p
 
 // ------------------------------------------------------------------------------------------------
 BoxCollider::BoxCollider(const std::shared_ptr<Meshable>& target)
-  : Physical(target), WFBoxBuilder(glm::vec3(0.0)), OBBSeparatingAxis()
+  : Physical(target, CollisionUtils::shapeType<BoxCollider>()), WFBoxBuilder(glm::vec3(0.0)), m_worldOBB()
 {
   const auto infos = getBoundsInfo(target);
   if (!infos.has_value())
@@ -55,7 +55,7 @@ BoxCollider::BoxCollider(const std::shared_ptr<Meshable>& target)
 
   m_scale = infos->first;
   //m_localToParent = glm::translate(target->getLocalToParent(), infos->second);
-  m_localToParent = target->getLocalToParent();
+  setLocalToParent(target->getLocalToParent());
   target->setLocalToParent(glm::translate(glm::mat4(1.0), -infos->second));
 
   Meshable::makeMesh(makeMeshContent(
@@ -68,7 +68,7 @@ BoxCollider::BoxCollider(const std::shared_ptr<Meshable>& target)
 
 // ------------------------------------------------------------------------------------------------
 BoxCollider::BoxCollider(const std::shared_ptr<TexturedMesh>& mesh)
-  : Physical(mesh), WFBoxBuilder(glm::vec3(0.0)), OBBSeparatingAxis()
+  : Physical(mesh, CollisionUtils::shapeType<BoxCollider>()), WFBoxBuilder(glm::vec3(0.0)), m_worldOBB()
 {
   const auto infos = getBoundsInfo(mesh);
   if (!infos.has_value())
@@ -78,7 +78,7 @@ BoxCollider::BoxCollider(const std::shared_ptr<TexturedMesh>& mesh)
 
   m_scale = infos->first;
   //m_localToParent = glm::translate(mesh->getLocalToParent(), infos->second);
-  m_localToParent = mesh->getLocalToParent();
+  setLocalToParent(mesh->getLocalToParent());
   mesh->setLocalToParent(glm::translate(glm::mat4(1.0), -infos->second));
 
 #ifdef _DEBUG
@@ -92,15 +92,54 @@ BoxCollider::BoxCollider(const std::shared_ptr<TexturedMesh>& mesh)
 }
 
 // ------------------------------------------------------------------------------------------------
-CurrentTargetCollisions BoxCollider::computeCollision(CollisionManager* colMan)
+void BoxCollider::updateWorldCache()
 {
-  return colMan->computeTargetCollisions(this);
+  m_worldOBB.transform = localToWorld();
+  m_worldOBB.inverse = glm::inverse(m_worldOBB.transform);
+  m_worldOBB.halfExtents = m_scale * 0.5f;
+  m_worldOBB.corners = SeparatingAxis::makeCorners(m_worldOBB.transform, m_worldOBB.halfExtents);
+}
+
+// ------------------------------------------------------------------------------------------------
+const BoxCollider::WorldOBB& BoxCollider::getWorldOBB() const
+{
+  return m_worldOBB;
+}
+
+// ------------------------------------------------------------------------------------------------
+BoundingBox BoxCollider::computeWorldBounds() const
+{
+  glm::mat4 tr = localToWorld();
+  glm::vec3 center = tr[3];
+  glm::vec3 halfScale = m_scale * 0.5f;
+
+  // Project the OBB half-extents onto each World Axis
+  glm::vec3 extent =
+    glm::abs(glm::vec3(tr[0])) * halfScale.x +
+    glm::abs(glm::vec3(tr[1])) * halfScale.y +
+    glm::abs(glm::vec3(tr[2])) * halfScale.z;
+
+  return BoundingBox{ center - extent, center + extent };
+}
+
+// ------------------------------------------------------------------------------------------------
+std::optional<float> BoxCollider::rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const
+{
+  // Slab test in the Box local space
+  glm::mat4 worldToLocal = glm::inverse(localToWorld());
+  glm::vec3 localOrigin = worldToLocal * glm::vec4(origin, 1.0);
+  glm::vec3 localDirection = glm::mat3(worldToLocal) * direction;
+
+  glm::vec3 halfScale = m_scale * 0.5f;
+  BoundingBox localBounds{ -halfScale, halfScale };
+
+  return localBounds.intersects(localOrigin, 1.0f / localDirection, maxDistance);
 }
 
 // ------------------------------------------------------------------------------------------------
 void BoxCollider::beforeInitialize(Renderer* renderer)
 {
-  Meshable::initializeMesh();
+  Meshable::initializeMesh(renderer);
 
   Physical::beforeInitialize(renderer);
 }
@@ -109,8 +148,11 @@ void BoxCollider::beforeInitialize(Renderer* renderer)
 void BoxCollider::beforeUpdate(Renderer* renderer, UpdateData& data)
 {
 #ifdef _DEBUG
-  Meshable::updateRenderable(renderer, data.localToWorld,
-                             12 * // Lines on Cube
-                             2);  // Values amount
+  if (!data.render)
+  {
+    return;
+  }
+
+  Meshable::updateRenderable(renderer, data.localToWorld);
 #endif
 }
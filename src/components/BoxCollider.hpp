@@ -3,22 +3,36 @@
 #include "Physical.hpp"
 #include "TexturedMesh.hpp"
 
+#include "SeparatingAxis.hpp"
+
 #include "builders/WFBoxBuilder.hpp"
 
 class BoxCollider final : public Physical, public WFBoxBuilder
 {
+public:
+  // Transform columns hold the World axes and center
+  struct WorldOBB
+  {
+    glm::mat4 transform;
+    glm::mat4 inverse;
+    glm::vec3 halfExtents;
+    SeparatingAxis::Corners corners;
+  };
+
 public:
   BoxCollider(const std::shared_ptr<Meshable>& target);
   BoxCollider(const std::shared_ptr<TexturedMesh>& mesh);
 
-  CurrentTargetCollisions computeCollision(CollisionManager* colMan) override;
+  void updateWorldCache() override;
+  const WorldOBB& getWorldOBB() const;
+
+  BoundingBox computeWorldBounds() const override;
+  std::optional<float> rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const override;
 
 protected:
   void beforeInitialize(Renderer* renderer) override;
   void beforeUpdate(Renderer* renderer, UpdateData& data) override;
 
-public:
-  // 15 ------- 7 - 6 -------- 1 - 0
-  // 9 Edges Axis - 6 Faces Axis - 1
-  std::map<BoxCollider*, uint16_t> OBBSeparatingAxis;
+private:
+  WorldOBB m_worldOBB;
 };
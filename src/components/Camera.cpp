@@ -145,8 +145,13 @@ void Camera::beforeInitialize(Renderer* renderer)
 // ------------------------------------------------------------------------------------------------
 void Camera::beforeUpdate(Renderer* renderer, UpdateData& data)
 {
+  if (!data.render)
+  {
+    return;
+  }
+
   // Process Inputs
-  inputCallback(renderer->getWindow(), h_step);
+  inputCallback(renderer->getWindow(), data.dt);
 
   // Update Transforms
   glm::mat4 mat = computeView();
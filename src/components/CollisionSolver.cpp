@@ -1,76 +1,460 @@
 #include "CollisionSolver.hpp"
 
+#include "Profiler.hpp"
 #include "RigidBody.hpp"
 
+#include <algorithm>
+#include <limits>
+
+// ------------------------------------------------------------------------------------------------
+CollisionSolver::CollisionSolver(CollisionManager* manager, size_t iterations)
+  : m_manager(manager), m_iterations(iterations), m_warmStarting(true), m_threadPool(nullptr)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionSolver::setIterations(size_t iterations)
+{
+  m_iterations = iterations;
+}
+
 // ------------------------------------------------------------------------------------------------
-CollisionSolver::CollisionSolver(CollisionManager* manager)
-  : m_manager(manager)
+size_t CollisionSolver::getIterations() const
 {
+  return m_iterations;
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionSolver::setWarmStarting(bool enabled)
+{
+  m_warmStarting = enabled;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool CollisionSolver::isWarmStarting() const
+{
+  return m_warmStarting;
 }
 
 // ------------------------------------------------------------------------------------------------
 void CollisionSolver::beforeUpdate(Renderer* renderer, UpdateData& data)
 {
-  auto reflect = [](glm::vec3 v, glm::vec3 n)
+  if (!data.simulate)
   {
-    return 2.0f * glm::dot(-v, n) * n + v;
-  };
+    return;
+  }
+
+  PROFILE_SCOPE("CollisionSolver::beforeUpdate");
+
+  m_bodies.clear();
+  m_bodyIndices.clear();
+  m_constraints.clear();
+
+  for (const auto& contact : m_manager->computeAllCollisions())
+  {
+    prepareConstraint(contact);
+  }
+
+  // Pairs of a woken body were skipped as sleeping, they are tested again in the same step
+  // - the wake spreads through the whole island before the solve, which keeps its supports
+  size_t checked = 0;
+  while (wakeBodies(checked))
+  {
+    checked = m_constraints.size();
+    for (const auto& contact : m_manager->computeWokenCollisions())
+    {
+      prepareConstraint(contact);
+    }
+  }
 
-  auto collisionsMap = m_manager->computeAllCollisions();
+  buildIslands();
 
-  for (auto& collisions : collisionsMap)
+  // Velocities are predicted with this step's forces, as RigidBody integrates them after the solve
+  // - restitution was computed beforehand, resting contacts do not bounce on gravity
+  for (auto& solverBody : m_bodies)
   {
-    if (collisions.second.empty())
+    solverBody.linearVelocity += data.dt * solverBody.body->m_force / solverBody.body->m_mass;
+    solverBody.angularVelocity += data.dt * solverBody.body->getInvI() * solverBody.body->m_torque;
+  }
+
+  if (m_threadPool == nullptr || m_islands.size() < 2 || m_constraints.size() < MinParallelConstraints)
+  {
+    for (const auto& island : m_islands)
     {
-      continue;
+      solveIsland(island);
     }
+  }
+  else
+  {
+    // Islands share no moving body
+    m_threadPool->run(m_islands.size(), [&](size_t index)
+                      {
+                        solveIsland(m_islands[index]);
+                      });
+  }
 
-    auto target = collisions.first;
-    if (!target->hasBody())
+  // Impulses are added to the velocities the RigidBodies integrate
+  for (const auto& solverBody : m_bodies)
+  {
+    if (solverBody.invMass == 0.0f)
     {
       continue;
     }
 
-    auto body1 = target->getRigidBody();
-    if (body1->isKinematic())
+    solverBody.body->m_nextLinearVelocity += solverBody.invMass * solverBody.linearImpulse;
+    solverBody.body->m_nextAngularMomentum += solverBody.angularImpulse;
+  }
+
+  updateSleep();
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionSolver::setParallelIslands(bool enabled)
+{
+  if (enabled == isParallelIslands())
+  {
+    return;
+  }
+
+  m_threadPool = enabled ? std::make_unique<ThreadPool>() : nullptr;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool CollisionSolver::isParallelIslands() const
+{
+  return (m_threadPool != nullptr);
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t CollisionSolver::getIslandCount() const
+{
+  return m_islands.size();
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t CollisionSolver::getSolverBody(RigidBody* body)
+{
+  auto [it, inserted] = m_bodyIndices.try_emplace(body, m_bodies.size());
+  if (!inserted)
+  {
+    return it->second;
+  }
+
+  glm::mat3 invI = body->getInvI();
+
+  SolverBody solverBody;
+  solverBody.body = body;
+  solverBody.linearVelocity = body->m_nextLinearVelocity;
+  solverBody.angularVelocity = invI * body->m_nextAngularMomentum;
+  solverBody.linearImpulse = glm::vec3(0.0f);
+  solverBody.angularImpulse = glm::vec3(0.0f);
+
+  // Kinematic bodies are not moved by contacts
+  solverBody.invI = body->isKinematic() ? glm::mat3(0.0f) : invI;
+  solverBody.invMass = body->isKinematic() ? 0.0f : 1.0f / body->m_mass;
+  solverBody.island = m_bodies.size();
+
+  m_bodies.push_back(solverBody);
+
+  return it->second;
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionSolver::prepareConstraint(const CollisionManager::Contact& contact)
+{
+  if (!contact.bodyA->hasBody() || !contact.bodyB->hasBody())
+  {
+    return;
+  }
+
+  RigidBody* bodyA = contact.bodyA->getRigidBody();
+  RigidBody* bodyB = contact.bodyB->getRigidBody();
+  if (bodyA->isKinematic() && bodyB->isKinematic())
+  {
+    return;
+  }
+
+  const auto& [dataA, dataB] = contact.manifold;
+
+  // Manifolds give the direction pushing A out of B, along with a signed penetration
+  glm::vec3 normal = glm::normalize(dataA.normal);
+  if (dataA.penetration > 0.0f)
+  {
+    normal = -normal;
+  }
+
+  Constraint constraint;
+  constraint.bodyA = getSolverBody(bodyA);
+  constraint.bodyB = getSolverBody(bodyB);
+  constraint.rA = dataA.worldPosition - glm::vec3(bodyA->localToWorld()[3]);
+  constraint.rB = dataB.worldPosition - glm::vec3(bodyB->localToWorld()[3]);
+  constraint.normal = normal;
+  constraint.depth = glm::abs(dataA.penetration);
+  constraint.effectiveMass = getEffectiveMass(constraint, normal);
+  constraint.friction = glm::sqrt(bodyA->m_friction * bodyB->m_friction);
+  constraint.state = contact.state;
+
+  // Tangent basis orthogonal to the normal
+  glm::vec3 tangent = (glm::abs(normal.x) >= 0.57735f) ? glm::vec3(normal.y, -normal.x, 0.0f)
+                                                       : glm::vec3(0.0f, normal.z, -normal.y);
+  constraint.tangents[0] = glm::normalize(tangent);
+  constraint.tangents[1] = glm::cross(normal, constraint.tangents[0]);
+
+  for (size_t ii = 0; ii < 2; ++ii)
+  {
+    constraint.tangentMasses[ii] = getEffectiveMass(constraint, constraint.tangents[ii]);
+  }
+
+  // Warm Starting
+  // - the previous friction impulse is projected on the new basis
+  constraint.impulse = 0.0f;
+  constraint.tangentImpulses = { 0.0f, 0.0f };
+  if (m_warmStarting)
+  {
+    constraint.impulse = contact.state->normalImpulse;
+    for (size_t ii = 0; ii < 2; ++ii)
+    {
+      constraint.tangentImpulses[ii] = glm::dot(contact.state->frictionImpulse, constraint.tangents[ii]);
+    }
+  }
+
+  // Restitution targets a separating velocity from the approach one
+  float normalVelocity = glm::dot(getRelativeVelocity(constraint), normal);
+  float elasticity = glm::max(bodyA->m_elasticity, bodyB->m_elasticity);
+  constraint.velocityBias = (normalVelocity < -RestitutionThreshold) ? -elasticity * normalVelocity : 0.0f;
+
+  m_constraints.push_back(constraint);
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionSolver::applyImpulse(const Constraint& constraint, const glm::vec3& impulse)
+{
+  SolverBody& A = m_bodies[constraint.bodyA];
+  SolverBody& B = m_bodies[constraint.bodyB];
+
+  glm::vec3 LA = glm::cross(constraint.rA, impulse);
+  glm::vec3 LB = glm::cross(constraint.rB, impulse);
+
+  // Kinematic bodies are shared between islands, and left untouched
+  if (A.invMass != 0.0f)
+  {
+    A.linearVelocity -= A.invMass * impulse;
+    A.angularVelocity -= A.invI * LA;
+    A.linearImpulse -= impulse;
+    A.angularImpulse -= LA;
+  }
+
+  if (B.invMass != 0.0f)
+  {
+    B.linearVelocity += B.invMass * impulse;
+    B.angularVelocity += B.invI * LB;
+    B.linearImpulse += impulse;
+    B.angularImpulse += LB;
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+glm::vec3 CollisionSolver::getRelativeVelocity(const Constraint& constraint) const
+{
+  const SolverBody& A = m_bodies[constraint.bodyA];
+  const SolverBody& B = m_bodies[constraint.bodyB];
+
+  glm::vec3 velocityA = A.linearVelocity + glm::cross(A.angularVelocity, constraint.rA);
+  glm::vec3 velocityB = B.linearVelocity + glm::cross(B.angularVelocity, constraint.rB);
+
+  return velocityB - velocityA;
+}
+
+// ------------------------------------------------------------------------------------------------
+float CollisionSolver::getEffectiveMass(const Constraint& constraint, const glm::vec3& direction) const
+{
+  const SolverBody& A = m_bodies[constraint.bodyA];
+  const SolverBody& B = m_bodies[constraint.bodyB];
+
+  glm::vec3 rdA = glm::cross(constraint.rA, direction);
+  glm::vec3 rdB = glm::cross(constraint.rB, direction);
+  float invEffectiveMass = A.invMass + B.invMass + glm::dot(rdA, A.invI * rdA) + glm::dot(rdB, B.invI * rdB);
+
+  return (invEffectiveMass > 0.0f) ? 1.0f / invEffectiveMass : 0.0f;
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t CollisionSolver::findIsland(size_t body)
+{
+  while (m_bodies[body].island != body)
+  {
+    m_bodies[body].island = m_bodies[m_bodies[body].island].island;
+    body = m_bodies[body].island;
+  }
+
+  return body;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool CollisionSolver::wakeBodies(size_t begin)
+{
+  bool hasWoken = false;
+
+  // Contacts only exist for sleeping bodies touched by a moving one
+  for (size_t index = begin; index < m_constraints.size(); ++index)
+  {
+    for (size_t body : { m_constraints[index].bodyA, m_constraints[index].bodyB })
+    {
+      RigidBody* rigidBody = m_bodies[body].body;
+      if (rigidBody->isSleeping())
+      {
+        rigidBody->wakeUp();
+        hasWoken = true;
+      }
+    }
+  }
+
+  return hasWoken;
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionSolver::buildIslands()
+{
+  for (const auto& constraint : m_constraints)
+  {
+    SolverBody& A = m_bodies[constraint.bodyA];
+    SolverBody& B = m_bodies[constraint.bodyB];
+
+    // Kinematic bodies do not link islands
+    if (A.invMass == 0.0f || B.invMass == 0.0f)
     {
       continue;
     }
 
-    for (const auto& result : collisions.second)
+    m_bodies[findIsland(constraint.bodyA)].island = findIsland(constraint.bodyB);
+  }
+
+  // Constraints are grouped by island, keeping their order within each island
+  constexpr size_t NoIsland = std::numeric_limits<size_t>::max();
+
+  m_islands.clear();
+  m_islandIndices.assign(m_bodies.size(), NoIsland);
+
+  auto getIsland = [&](const Constraint& constraint) -> size_t&
+  {
+    size_t body = (m_bodies[constraint.bodyA].invMass != 0.0f) ? constraint.bodyA : constraint.bodyB;
+    return m_islandIndices[findIsland(body)];
+  };
+
+  for (const auto& constraint : m_constraints)
+  {
+    size_t& island = getIsland(constraint);
+    if (island == NoIsland)
+    {
+      island = m_islands.size();
+      m_islands.push_back(Island{ 0, 0 });
+    }
+
+    ++m_islands[island].end;
+  }
+
+  size_t begin = 0;
+  for (auto& island : m_islands)
+  {
+    size_t size = island.end;
+    island = Island{ begin, begin };
+    begin += size;
+  }
+
+  m_islandConstraints.resize(m_constraints.size());
+  for (const auto& constraint : m_constraints)
+  {
+    m_islandConstraints[m_islands[getIsland(constraint)].end++] = constraint;
+  }
+  std::swap(m_constraints, m_islandConstraints);
+
+  // Largest islands first, for a better balance between threads
+  std::stable_sort(m_islands.begin(), m_islands.end(), [](const Island& lhs, const Island& rhs)
+                   {
+                     return (lhs.end - lhs.begin) > (rhs.end - rhs.begin);
+                   });
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionSolver::solveIsland(const Island& island)
+{
+  PROFILE_SCOPE("CollisionSolver::solveIsland");
+
+  // Warm Starting
+  for (size_t index = island.begin; index < island.end; ++index)
+  {
+    const Constraint& constraint = m_constraints[index];
+    applyImpulse(constraint, constraint.impulse * constraint.normal +
+                             constraint.tangentImpulses[0] * constraint.tangents[0] +
+                             constraint.tangentImpulses[1] * constraint.tangents[1]);
+  }
+
+  // Velocities
+  // - the accumulated normal impulse may decrease, but never pulls bodies together
+  for (size_t iteration = 0; iteration < m_iterations; ++iteration)
+  {
+    for (size_t index = island.begin; index < island.end; ++index)
     {
-      if (!result.first->hasBody())
+      Constraint& constraint = m_constraints[index];
+
+      float maxFriction = constraint.friction * constraint.impulse;
+      for (size_t ii = 0; ii < 2; ++ii)
       {
-        continue;
+        const glm::vec3& tangent = constraint.tangents[ii];
+
+        float impulse = -constraint.tangentMasses[ii] * glm::dot(getRelativeVelocity(constraint), tangent);
+        float accumulated = glm::clamp(constraint.tangentImpulses[ii] + impulse, -maxFriction, maxFriction);
+
+        applyImpulse(constraint, (accumulated - constraint.tangentImpulses[ii]) * tangent);
+        constraint.tangentImpulses[ii] = accumulated;
       }
 
-      auto body2 = result.first->getRigidBody();
+      float normalVelocity = glm::dot(getRelativeVelocity(constraint), constraint.normal);
+      float impulse = constraint.effectiveMass * (constraint.velocityBias - normalVelocity);
+      float accumulated = glm::max(constraint.impulse + impulse, 0.0f);
 
-      glm::vec3 r1 = result.second.first.worldPosition - glm::vec3(body1->localToWorld()[3]);
-      glm::vec3 r2 = result.second.second.worldPosition - glm::vec3(body2->localToWorld()[3]);
+      applyImpulse(constraint, (accumulated - constraint.impulse) * constraint.normal);
+      constraint.impulse = accumulated;
+    }
+  }
 
-      glm::mat3 invI1 = body1->getInvI();
-      glm::mat3 invI2 = body2->getInvI();
+  // Positions
+  // - only part of the penetration is removed, split by inverse masses
+  for (size_t index = island.begin; index < island.end; ++index)
+  {
+    const Constraint& constraint = m_constraints[index];
 
-      glm::vec3 v1 = body1->m_currLinearVelocity;
-      glm::vec3 w1 = invI1 * body1->m_currAngularMomentum;
-      glm::vec3 v2 = body2->m_currLinearVelocity;
-      glm::vec3 w2 = invI2 * body2->m_currAngularMomentum;
-      glm::vec3 n = glm::normalize(result.second.first.normal);
+    constraint.state->normalImpulse = constraint.impulse;
+    constraint.state->frictionImpulse = constraint.tangentImpulses[0] * constraint.tangents[0] +
+                                        constraint.tangentImpulses[1] * constraint.tangents[1];
 
-      float m1 = body1->m_mass;
-      float m2 = body2->m_mass;
+    SolverBody& A = m_bodies[constraint.bodyA];
+    SolverBody& B = m_bodies[constraint.bodyB];
 
-      float impulse = (1 + body1->m_elasticity) *
-        (glm::dot(v1 - v2, n) + glm::dot(glm::cross(r1, n), w1) - glm::dot(glm::cross(r2, n), w2)) /
-        ((1 / m1) + (1 / m2) +
-          glm::dot(glm::cross(r1, n), invI1 * glm::cross(r1, n)) +
-          glm::dot(glm::cross(r2, n), invI2 * glm::cross(r2, n)));
-      glm::vec3 j = impulse * n;
+    float correction = PositionCorrection * glm::max(constraint.depth - PenetrationSlop, 0.0f) / (A.invMass + B.invMass);
+    if (A.invMass != 0.0f) A.body->m_position -= constraint.normal * (correction * A.invMass);
+    if (B.invMass != 0.0f) B.body->m_position += constraint.normal * (correction * B.invMass);
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+void CollisionSolver::updateSleep()
+{
+  m_restingIslands.assign(m_bodies.size(), true);
 
-      body1->m_position += n * result.second.first.penetration;
-      body1->m_nextLinearVelocity -= j / m1;
-      body1->m_nextAngularMomentum -= glm::cross(j, r1);
+  for (size_t index = 0; index < m_bodies.size(); ++index)
+  {
+    if (m_bodies[index].invMass != 0.0f && m_bodies[index].body->m_restingSteps < RigidBody::SleepSteps)
+    {
+      m_restingIslands[findIsland(index)] = false;
+    }
+  }
+
+  for (size_t index = 0; index < m_bodies.size(); ++index)
+  {
+    if (m_bodies[index].invMass != 0.0f && m_restingIslands[findIsland(index)])
+    {
+      m_bodies[index].body->sleep();
     }
   }
 }
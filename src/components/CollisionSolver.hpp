@@ -2,14 +2,107 @@
 
 #include "CollisionManager.hpp"
 
+// Sequential impulses solver
+// - contacts are solved together over several iterations, accumulated impulses are clamped
+// - impulses of the previous step are applied first (warm starting)
+// - friction impulses are bounded by the normal one (Coulomb)
+// - bodies linked by contacts form islands, solved independently and put to sleep together
 class CollisionSolver final : public Component
 {
 public:
-  CollisionSolver(CollisionManager* manager);
+  CollisionSolver(CollisionManager* manager, size_t iterations = 10);
+
+  void setIterations(size_t iterations);
+  size_t getIterations() const;
+
+  void setWarmStarting(bool enabled);
+  bool isWarmStarting() const;
+
+  // Islands are spread over a ThreadPool, results do not depend on the mode
+  void setParallelIslands(bool enabled);
+  bool isParallelIslands() const;
+
+  // Islands of the last step
+  size_t getIslandCount() const;
 
 protected:
   void beforeUpdate(Renderer* renderer, UpdateData& data) override;
 
+private:
+  // Velocities of a RigidBody during the solve, written back once done
+  struct SolverBody
+  {
+    RigidBody* body;
+    glm::vec3 linearVelocity;
+    glm::vec3 angularVelocity;
+    glm::vec3 linearImpulse;
+    glm::vec3 angularImpulse;
+    glm::mat3 invI;
+    float invMass;
+    size_t island; // Parent in the islands union-find
+  };
+
+  // Non penetration constraint, normal goes from A to B
+  struct Constraint
+  {
+    size_t bodyA;
+    size_t bodyB;
+    glm::vec3 rA;
+    glm::vec3 rB;
+    glm::vec3 normal;
+    float depth;
+    float effectiveMass;
+    float velocityBias;
+    float impulse;
+    float friction; // Friction impulse bound, relative to the normal impulse
+    std::array<glm::vec3, 2> tangents;
+    std::array<float, 2> tangentMasses;
+    std::array<float, 2> tangentImpulses;
+    CollisionUtils::PairState* state;
+  };
+
+  // Range of consecutive constraints
+  struct Island
+  {
+    size_t begin;
+    size_t end;
+  };
+
+  // Penetration left uncorrected, avoids jittering on resting contacts
+  static constexpr float PenetrationSlop = 0.005f;
+  // Fraction of the penetration removed each step
+  static constexpr float PositionCorrection = 0.4f;
+  // Below this approach speed, contacts do not bounce
+  static constexpr float RestitutionThreshold = 0.5f;
+  // Below this amount of constraints, threads cost more than they save
+  static constexpr size_t MinParallelConstraints = 64;
+
+  size_t getSolverBody(RigidBody* body);
+  void prepareConstraint(const CollisionManager::Contact& contact);
+  void applyImpulse(const Constraint& constraint, const glm::vec3& impulse);
+  glm::vec3 getRelativeVelocity(const Constraint& constraint) const;
+  float getEffectiveMass(const Constraint& constraint, const glm::vec3& direction) const;
+
+  // Wakes the sleeping bodies of the constraints from begin, true if any was
+  bool wakeBodies(size_t begin);
+
+  size_t findIsland(size_t body);
+  void buildIslands();
+  void solveIsland(const Island& island);
+  void updateSleep();
+
 private:
   CollisionManager* m_manager;
-};
\ No newline at end of file
+  size_t m_iterations;
+  bool m_warmStarting;
+
+  std::vector<SolverBody> m_bodies;
+  std::unordered_map<RigidBody*, size_t> m_bodyIndices;
+  std::vector<Constraint> m_constraints;
+  std::vector<Constraint> m_islandConstraints;
+  std::vector<Island> m_islands;
+  std::vector<size_t> m_islandIndices;
+  std::vector<bool> m_restingIslands;
+
+  std::unique_ptr<ThreadPool> m_threadPool;
+};
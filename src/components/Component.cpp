@@ -15,27 +15,48 @@
 #include <iostream>
 #include <numeric>
 
+// ------------------------------------------------------------------------------------------------
+Component::~Component()
+{
+  // Children kept alive elsewhere become roots
+  for (auto& child : m_children)
+  {
+    if (child->m_parent == this)
+    {
+      child->setParent(nullptr);
+    }
+  }
+}
+
 // ------------------------------------------------------------------------------------------------
 void Component::setLocalToParent(const glm::mat4& model)
 {
   m_localToParent = model;
+  markWorldDirty();
 }
 
 // ------------------------------------------------------------------------------------------------
 void Component::setLocalToParent(const glm::vec3& trsl, const glm::vec3& rot)
 {
-  glm::mat4 tr = glm::rotate(rot.x, glm::vec3(1.0, 0.0, 0.0)) *
-                 glm::rotate(rot.y, glm::vec3(0.0, 1.0, 0.0)) *
-                 glm::rotate(rot.z, glm::vec3(0.0, 0.0, 1.0));
-  m_localToParent = glm::translate(glm::mat4(1.0), trsl) * tr;
+  m_localToParent = makeTransform(trsl, rot);
+  markWorldDirty();
 }
 
 // ------------------------------------------------------------------------------------------------
-glm::mat4 Component::getLocalToParent() const
+const glm::mat4& Component::getLocalToParent() const
 {
   return m_localToParent;
 }
 
+// ------------------------------------------------------------------------------------------------
+glm::mat4 Component::makeTransform(const glm::vec3& trsl, const glm::vec3& rot)
+{
+  glm::mat4 tr = glm::rotate(rot.x, glm::vec3(1.0, 0.0, 0.0)) *
+                 glm::rotate(rot.y, glm::vec3(0.0, 1.0, 0.0)) *
+                 glm::rotate(rot.z, glm::vec3(0.0, 0.0, 1.0));
+  return glm::translate(glm::mat4(1.0), trsl) * tr;
+}
+
 // ------------------------------------------------------------------------------------------------
 bool Component::addChild(const Pointer& child)
 {
@@ -53,6 +74,12 @@ bool Component::addChild(const Pointer& child)
 // ------------------------------------------------------------------------------------------------
 bool Component::removeChild(const Pointer& child)
 {
+  if (!containsChild(child))
+  {
+    return false;
+  }
+
+  child->setParent(nullptr);
   return std::erase(m_children, child) > 0;
 }
 
@@ -64,6 +91,7 @@ bool Component::removeChild(int index)
     return false;
   }
 
+  m_children[index]->setParent(nullptr);
   m_children.erase(m_children.begin() + index);
   return true;
 }
@@ -71,6 +99,11 @@ bool Component::removeChild(int index)
 // ------------------------------------------------------------------------------------------------
 void Component::removeChildren()
 {
+  for (auto& child : m_children)
+  {
+    child->setParent(nullptr);
+  }
+
   m_children.clear();
 }
 
@@ -103,17 +136,34 @@ bool Component::containsChild(const Pointer& child) const
 void Component::setParent(Component* parent)
 {
   m_parent = parent;
+  markWorldDirty();
 }
 
 // ------------------------------------------------------------------------------------------------
-glm::mat4 Component::localToWorld() const
+const glm::mat4& Component::localToWorld() const
 {
-  if (m_parent != nullptr)
+  if (m_isWorldDirty)
   {
-    return m_parent->localToWorld() * m_localToParent;
+    m_localToWorld = (m_parent != nullptr) ? m_parent->localToWorld() * m_localToParent : m_localToParent;
+    m_isWorldDirty = false;
   }
 
-  return m_localToParent;
+  return m_localToWorld;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Component::markWorldDirty()
+{
+  if (m_isWorldDirty)
+  {
+    return;
+  }
+
+  m_isWorldDirty = true;
+  for (auto& child : m_children)
+  {
+    child->markWorldDirty();
+  }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -18,10 +18,17 @@ public:
   using UPointer = std::unique_ptr<Component>;
 
 public:
+  virtual ~Component();
+
+  Component(const Component&) = delete;
+  Component& operator=(const Component&) = delete;
+
   void setLocalToParent(const glm::mat4& model);
   void setLocalToParent(const glm::vec3& trsl = glm::vec3(0.0),
                         const glm::vec3& rot = glm::vec3(0.0));
-  glm::mat4 getLocalToParent() const;
+  const glm::mat4& getLocalToParent() const;
+
+  static glm::mat4 makeTransform(const glm::vec3& trsl, const glm::vec3& rot);
 
   bool addChild(const Pointer& child);
   bool removeChild(const Pointer& child);
@@ -32,7 +39,10 @@ public:
   bool containsChild(const Pointer& child) const;
 
   void setParent(Component* parent);
-  glm::mat4 localToWorld() const;
+
+  // Cached, recomputed on the first read after this or an ancestor transform changed
+  // - not thread safe while dirty, CollisionManager refreshes its colliders serially each step
+  const glm::mat4& localToWorld() const;
 
 public:
   virtual void initialize(Renderer* renderer);
@@ -45,9 +55,17 @@ protected:
 protected:
   Component() = default;
 
+private:
+  // Dirty nodes only have dirty descendants, propagation stops at the first dirty one
+  void markWorldDirty();
+
 protected:
-  glm::mat4 m_localToParent;
+  glm::mat4 m_localToParent = glm::mat4(1.0);
   Collection m_children;
 
   Component* m_parent = nullptr;
+
+private:
+  mutable glm::mat4 m_localToWorld = glm::mat4(1.0);
+  mutable bool m_isWorldDirty = true;
 };
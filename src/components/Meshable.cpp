@@ -1,9 +1,12 @@
 #include "Meshable.hpp"
 
+#include "Renderer.hpp"
+
 // ------------------------------------------------------------------------------------------------
 Meshable::Meshable()
   : m_vertices(0),
-  m_indexes(0)
+  m_indexes(0),
+  m_coarserLevels(0)
 {
 }
 
@@ -12,6 +15,19 @@ void Meshable::makeMesh(const Builder::Result& content)
 {
   m_vertices = content.vertices;
   m_indexes = content.indexes;
+  m_coarserLevels.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Meshable::makeMesh(const Builder::LevelsOfDetail& levels)
+{
+  if (levels.empty())
+  {
+    return;
+  }
+
+  makeMesh(levels.front());
+  m_coarserLevels.assign(levels.begin() + 1, levels.end());
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -27,12 +43,16 @@ std::vector<GLuint> Meshable::getIndexes() const
 }
 
 // ------------------------------------------------------------------------------------------------
-void Meshable::initializeMesh()
+void Meshable::initializeMesh(Renderer* renderer)
 {
-  if (m_vertices.empty() || m_indexes.empty())
+  if (renderer->isHeadless() || m_vertices.empty() || m_indexes.empty())
   {
     return;
   }
 
-  Renderable::initializeRenderable(m_vertices, m_indexes);
+  Renderable::initializeRenderable(renderer, m_vertices, m_indexes);
+  for (const Builder::Result& level : m_coarserLevels)
+  {
+    Renderable::initializeRenderable(renderer, level.vertices, level.indexes);
+  }
 }
@@ -11,8 +11,12 @@ protected:
 protected:
   void makeMesh(const Builder::Result& content);
 
+  // The finest level is the mesh content, the coarser ones are only drawn
+  void makeMesh(const Builder::LevelsOfDetail& levels);
+
 public:
-  void initializeMesh();
+  // Nothing is created on headless renderers
+  void initializeMesh(Renderer* renderer);
 
   std::vector<VertexType> getVertices() const;
   std::vector<GLuint> getIndexes() const;
@@ -20,4 +24,6 @@ public:
 protected:
   std::vector<VertexType> m_vertices;
   std::vector<GLuint> m_indexes;
+
+  std::vector<Builder::Result> m_coarserLevels;
 };
@@ -4,8 +4,8 @@
 #include "CollisionManager.hpp"
 
 // ------------------------------------------------------------------------------------------------
-Physical::Physical(const std::shared_ptr<Component>& target)
-  : Meshable(), m_body(nullptr)
+Physical::Physical(const std::shared_ptr<Component>& target, ShapeType shapeType)
+  : Meshable(), m_body(nullptr), m_shapeType(shapeType), m_physicalId(0)
 {
   Renderable::mode = GL_LINES;
 
@@ -35,6 +35,18 @@ bool Physical::hasBody() const
   return (m_body != nullptr);
 }
 
+// ------------------------------------------------------------------------------------------------
+Physical::ShapeType Physical::getShapeType() const
+{
+  return m_shapeType;
+}
+
+// ------------------------------------------------------------------------------------------------
+uint32_t Physical::getPhysicalId() const
+{
+  return m_physicalId;
+}
+
 // ------------------------------------------------------------------------------------------------
 void Physical::beforeInitialize(Renderer* renderer)
 {
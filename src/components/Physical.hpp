@@ -6,9 +6,13 @@ class Physical : public Meshable
 {
 public:
   friend RigidBody;
+  friend CollisionManager;
+
+  // Index of the concrete type in CollisionUtils::PhysicalTypes
+  using ShapeType = uint8_t;
 
 protected:
-  Physical(const std::shared_ptr<Component>& target);
+  Physical(const std::shared_ptr<Component>& target, ShapeType shapeType);
 
 public:
   virtual ~Physical();
@@ -16,14 +20,27 @@ public:
   RigidBody* getRigidBody() const;
   bool hasBody() const;
 
+  ShapeType getShapeType() const;
+
+  // Unique while registered in a CollisionManager, 0 otherwise
+  uint32_t getPhysicalId() const;
+
 protected:
   virtual void beforeInitialize(Renderer* renderer) override;
 
   void setRigidBody(RigidBody* body);
 
 public:
-  virtual CurrentTargetCollisions computeCollision(CollisionManager* colMan) = 0;
+  // Refreshes the World space data read by the narrowphase, once per step
+  virtual void updateWorldCache() = 0;
+
+  virtual BoundingBox computeWorldBounds() const = 0;
+
+  // Distance along a normalized World Ray to the first hit, if any before maxDistance
+  virtual std::optional<float> rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const = 0;
 
 private:
   RigidBody* m_body;
+  ShapeType m_shapeType;
+  uint32_t m_physicalId;
 };
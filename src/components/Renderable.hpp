@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Component.hpp"
+#include "MeshRegistry.hpp"
 
 class Renderable : public Component
 {
@@ -8,17 +9,15 @@ protected:
   Renderable();
 
 protected:
-  virtual void initializeRenderable(std::vector<VertexType> vertices, std::vector<GLuint> index);
-  virtual void updateRenderable(Renderer* renderer, glm::mat4 localToWorld, GLsizei nValues);
+  // Each call adds a level of detail, from the finest to the coarsest
+  virtual void initializeRenderable(Renderer* renderer, std::vector<VertexType> vertices, std::vector<GLuint> index);
 
-protected:
-  // shader
-  Shader vertexShader;
-  Shader fragmentShader;
-  ShaderProgram shaderProgram;
+  // Adds an instance of the level matching its screen size, drawn with the identical renderables once the render pass is done
+  virtual void updateRenderable(Renderer* renderer, const glm::mat4& localToWorld);
 
-  // VBO/VAO/ibo
-  GLuint vao, vbo, ibo;
+protected:
+  // GPU meshes per level of detail, shared with the identical renderables through the renderer registry
+  std::vector<MeshRegistry::Mesh*> meshes;
 
   // Draw Mode
   GLenum mode;
@@ -1,6 +1,7 @@
 #include "RigidBody.hpp"
 
 #include "Physical.hpp"
+#include "Profiler.hpp"
 #include "Renderer.hpp"
 #include "RigidBody.hpp"
 
@@ -10,11 +11,13 @@
 // ------------------------------------------------------------------------------------------------
 RigidBody::RigidBody(const std::shared_ptr<Physical>& target,
                      float mass, float elasticity, bool isKinematic, bool useGravity)
-  : m_target(target), m_mass(1.0), m_elasticity(0.0), m_isKinematic(isKinematic), m_useGravity(false),
+  : m_target(target), m_mass(1.0), m_elasticity(0.0), m_friction(DefaultFriction), m_isKinematic(isKinematic), m_useGravity(false),
   m_position(glm::vec3(0.0)), m_rotation(glm::vec3(0.0)),
+  m_previousPosition(glm::vec3(0.0)), m_previousRotation(glm::vec3(0.0)),
   m_currLinearVelocity(glm::vec3(0.0)), m_nextLinearVelocity(glm::vec3(0.0)),
   m_currAngularMomentum(glm::vec3(0.0)), m_nextAngularMomentum(glm::vec3(0.0)),
-  m_force(glm::vec3(0.0)), m_torque(glm::vec3(0.0))
+  m_force(glm::vec3(0.0)), m_torque(glm::vec3(0.0)),
+  m_isSleeping(false), m_restingSteps(0)
 {
   setMass(mass);
   setElasticity(elasticity);
@@ -33,6 +36,7 @@ RigidBody::RigidBody(const std::shared_ptr<Physical>& target,
 // ------------------------------------------------------------------------------------------------
 size_t RigidBody::addForce(const ExternalForce& force)
 {
+  wakeUp();
   m_external_forces.push_back(force);
   computeForceTorque();
 
@@ -42,6 +46,7 @@ size_t RigidBody::addForce(const ExternalForce& force)
 // ------------------------------------------------------------------------------------------------
 size_t RigidBody::addForces(const std::vector<ExternalForce>& forces)
 {
+  wakeUp();
   m_external_forces.insert(m_external_forces.end(), forces.begin(), forces.end());
   computeForceTorque();
 
@@ -56,6 +61,7 @@ bool RigidBody::removeForce(size_t index)
     return false;
   }
 
+  wakeUp();
   m_external_forces.erase(m_external_forces.begin() + index);
   computeForceTorque();
 
@@ -101,9 +107,29 @@ float RigidBody::getElasticity() const
   return m_elasticity;
 }
 
+// ------------------------------------------------------------------------------------------------
+bool RigidBody::setFriction(float friction)
+{
+  if (friction < 0.0)
+  {
+    return false;
+  }
+
+  m_friction = friction;
+
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+float RigidBody::getFriction() const
+{
+  return m_friction;
+}
+
 // ------------------------------------------------------------------------------------------------
 void RigidBody::setKinematicState(bool isKinematic)
 {
+  wakeUp();
   m_isKinematic = isKinematic;
 }
 
@@ -116,6 +142,7 @@ bool RigidBody::isKinematic() const
 // ------------------------------------------------------------------------------------------------
 void RigidBody::setGravityUse(bool useGravity)
 {
+  wakeUp();
   m_useGravity = useGravity;
 
   computeForceTorque();
@@ -130,19 +157,47 @@ bool RigidBody::useGravity() const
 // ------------------------------------------------------------------------------------------------
 void RigidBody::setInitLinearVelocity(glm::vec3 initLinearVelocity)
 {
+  wakeUp();
   m_nextLinearVelocity = initLinearVelocity;
 }
 
 // ------------------------------------------------------------------------------------------------
 void RigidBody::setInitAngularMomentum(glm::vec3 initAngularMomentum)
 {
+  wakeUp();
   m_nextAngularMomentum = initAngularMomentum;
 }
 
+// ------------------------------------------------------------------------------------------------
+void RigidBody::sleep()
+{
+  m_isSleeping = true;
+
+  m_currLinearVelocity = glm::vec3(0.0f);
+  m_nextLinearVelocity = glm::vec3(0.0f);
+  m_currAngularMomentum = glm::vec3(0.0f);
+  m_nextAngularMomentum = glm::vec3(0.0f);
+}
+
+// ------------------------------------------------------------------------------------------------
+void RigidBody::wakeUp()
+{
+  m_isSleeping = false;
+  m_restingSteps = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool RigidBody::isSleeping() const
+{
+  return m_isSleeping;
+}
+
 // ------------------------------------------------------------------------------------------------
 void RigidBody::translateBy(const glm::vec3& trsl)
 {
+  wakeUp();
   m_position += trsl;
+  m_previousPosition = m_position;
 
   updateTransform();
 }
@@ -150,7 +205,9 @@ void RigidBody::translateBy(const glm::vec3& trsl)
 // ------------------------------------------------------------------------------------------------
 void RigidBody::rotateBy(const glm::vec3& rot)
 {
+  wakeUp();
   m_rotation += rot;
+  m_previousRotation = m_rotation;
 
   updateTransform();
 }
@@ -170,7 +227,7 @@ void RigidBody::initialize(Renderer* renderer)
 // ------------------------------------------------------------------------------------------------
 glm::mat3 RigidBody::getInvI() const
 {
-  glm::mat3 rot = m_localToParent;
+  glm::mat3 rot = getLocalToParent();
   glm::mat3 rot_t = glm::transpose(rot);
   return rot * m_invIBody * rot_t;
 }
@@ -178,6 +235,26 @@ glm::mat3 RigidBody::getInvI() const
 // ------------------------------------------------------------------------------------------------
 void RigidBody::beforeUpdate(Renderer* renderer, UpdateData& data)
 {
+  PROFILE_SCOPE("RigidBody::beforeUpdate");
+
+  if (!data.simulate)
+  {
+    glm::vec3 position = glm::mix(m_previousPosition, m_position, data.alpha);
+    glm::vec3 rotation = glm::mix(m_previousRotation, m_rotation, data.alpha);
+    data.localToWorld = data.parentToWorld * makeTransform(position, rotation);
+    return;
+  }
+
+  // Solver corrections of the last step are not interpolated
+  m_previousPosition = m_position;
+  m_previousRotation = m_rotation;
+
+  if (m_isSleeping)
+  {
+    data.localToWorld = data.parentToWorld * getLocalToParent();
+    return;
+  }
+
   // Position
   m_nextLinearVelocity += data.dt * m_force / m_mass;
   m_currLinearVelocity = m_nextLinearVelocity;
@@ -192,8 +269,13 @@ void RigidBody::beforeUpdate(Renderer* renderer, UpdateData& data)
   // ---
   m_rotation += data.dt * angular_velocity;
 
+  // Sleep candidate
+  bool isResting = glm::length(m_currLinearVelocity) < SleepLinearVelocity &&
+                   glm::length(angular_velocity) < SleepAngularVelocity;
+  m_restingSteps = isResting ? m_restingSteps + 1 : 0;
+
   updateTransform();
-  data.localToWorld = data.parentToWorld * m_localToParent;
+  data.localToWorld = data.parentToWorld * getLocalToParent();
 }
 
 // ------------------------------------------------------------------------------------------------
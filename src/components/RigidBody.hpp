@@ -32,6 +32,10 @@ public:
   bool setElasticity(float elasticity);
   float getElasticity() const;
 
+  // Coulomb coefficient, combined with the one of the other body of a contact
+  bool setFriction(float friction);
+  float getFriction() const;
+
   void setKinematicState(bool isKinematic);
   bool isKinematic() const;
 
@@ -44,12 +48,25 @@ public:
   void setInitLinearVelocity(glm::vec3 initLinearVelocity);
   void setInitAngularMomentum(glm::vec3 initAngularMomentum);
 
+  // Sleeping bodies are neither integrated nor tested against other resting bodies
+  void sleep();
+  void wakeUp();
+  bool isSleeping() const;
+
 protected:
   void initialize(Renderer* renderer) override;
 
   glm::mat3 getInvI() const;
 
+public:
+  static constexpr float DefaultFriction = 0.4f;
+
 private:
+  // Below these velocities for SleepSteps consecutive steps, a body may sleep with its island
+  static constexpr float SleepLinearVelocity = 0.05f;
+  static constexpr float SleepAngularVelocity = 0.05f;
+  static constexpr size_t SleepSteps = 50;
+
   void beforeUpdate(Renderer* renderer, UpdateData& data) override;
 
   void updateTransform();
@@ -70,11 +87,19 @@ protected:
   glm::vec3 m_position;
   glm::vec3 m_rotation;
 
+  // State before the last step, render passes interpolate from it
+  glm::vec3 m_previousPosition;
+  glm::vec3 m_previousRotation;
+
   float m_mass;
   float m_elasticity;
+  float m_friction;
   bool m_isKinematic;
   bool m_useGravity;
 
+  bool m_isSleeping;
+  size_t m_restingSteps;
+
   std::vector<ExternalForce> m_external_forces;
 
   glm::vec3 m_force;
@@ -42,17 +42,25 @@ void scrollCallback(GLFWwindow* window, double xoffset, double yoffset)
 void Scene::construct(Renderer* renderer)
 {
   addChild(std::make_shared<Camera>());
-  addChild(std::make_shared<CollisionSolver>(renderer->getCollisionManager().get()));
+  auto collisionSolver = std::make_shared<CollisionSolver>(renderer->getCollisionManager().get());
+  m_collisionSolver = collisionSolver.get();
+  addChild(collisionSolver);
 
 #ifdef _DEBUG
   addChild(std::make_shared<World>());
 #endif
 }
 
+// ------------------------------------------------------------------------------------------------
+CollisionSolver* Scene::getCollisionSolver() const
+{
+  return m_collisionSolver;
+}
+
 // ------------------------------------------------------------------------------------------------
 void Scene::beforeInitialize(Renderer* renderer)
 {
-  if (mainCamera != nullptr)
+  if (mainCamera != nullptr && !renderer->isHeadless())
   {
     GLFWwindow* window = renderer->getWindow();
 
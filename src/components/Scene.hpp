@@ -12,7 +12,13 @@ public:
   virtual const char* getName() const = 0;
   virtual void construct(Renderer* renderer);
 
+  // Child created by construct, invalid once the children are removed
+  CollisionSolver* getCollisionSolver() const;
+
 protected:
   void beforeInitialize(Renderer* renderer) override;
   void beforeUpdate(Renderer* renderer, UpdateData& data) override;
+
+private:
+  CollisionSolver* m_collisionSolver = nullptr;
 };
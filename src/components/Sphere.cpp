@@ -3,10 +3,10 @@
 #include "CollisionManager.hpp"
 #include "Renderer.hpp"
 
-Sphere::Sphere(float radius)
-  : Meshable(), SphereBuilder(radius)
+Sphere::Sphere(float radius, int subdivisions)
+  : Meshable(), SphereBuilder(radius, subdivisions)
 {
-  Meshable::makeMesh(makeMeshContent(
+  Meshable::makeMesh(makeLevelsOfDetail(
     [](VertexType vt)
     {
       return glm::vec4(
@@ -20,13 +20,15 @@ Sphere::Sphere(float radius)
 
 void Sphere::beforeInitialize(Renderer* renderer)
 {
-  Meshable::initializeMesh();
+  Meshable::initializeMesh(renderer);
 }
 
 void Sphere::beforeUpdate(Renderer* renderer, UpdateData& data)
 {
-  Meshable::updateRenderable(renderer, data.localToWorld,
-                             20 *     // Faces on Icosahedron
-                             4 * 4 *  // Divisions
-                             3);      // Values amount
+  if (!data.render)
+  {
+    return;
+  }
+
+  Meshable::updateRenderable(renderer, data.localToWorld);
 }
\ No newline at end of file
@@ -6,7 +6,7 @@
 class Sphere : public Meshable, public SphereBuilder
 {
 public:
-  Sphere(float radius);
+  Sphere(float radius, int subdivisions = SphereBuilder::DefaultSubdivisions);
 
 protected:
   void beforeInitialize(Renderer* renderer) override;
@@ -46,7 +46,7 @@ std::optional<std::pair<float, glm::vec3>> getBoundsInfo(const std::shared_ptr<T
 
 // ------------------------------------------------------------------------------------------------
 SphereCollider::SphereCollider(const std::shared_ptr<Meshable>& target)
-  : Physical(target), WFSphereBuilder(0.0f)
+  : Physical(target, CollisionUtils::shapeType<SphereCollider>()), WFSphereBuilder(0.0f), m_worldCenter(0.0f)
 {
   const auto infos = getBoundsInfo(target);
   if (!infos.has_value())
@@ -56,7 +56,7 @@ SphereCollider::SphereCollider(const std::shared_ptr<Meshable>& target)
 
   m_radius = infos->first;
   //m_localToParent = glm::translate(target->getLocalToParent(), infos->second);
-  m_localToParent = target->getLocalToParent();
+  setLocalToParent(target->getLocalToParent());
   target->setLocalToParent(glm::translate(glm::mat4(1.0), -infos->second));
 
   Meshable::makeMesh(makeMeshContent(
@@ -69,7 +69,7 @@ SphereCollider::SphereCollider(const std::shared_ptr<Meshable>& target)
 
 // ------------------------------------------------------------------------------------------------
 SphereCollider::SphereCollider(const std::shared_ptr<TexturedMesh>& mesh)
-  : Physical(mesh), WFSphereBuilder(0.0f)
+  : Physical(mesh, CollisionUtils::shapeType<SphereCollider>()), WFSphereBuilder(0.0f), m_worldCenter(0.0f)
 {
   const auto infos = getBoundsInfo(mesh);
   if (!infos.has_value())
@@ -79,7 +79,7 @@ SphereCollider::SphereCollider(const std::shared_ptr<TexturedMesh>& mesh)
 
   m_radius = infos->first;
   //m_localToParent = glm::translate(mesh->getLocalToParent(), infos->second);
-  m_localToParent = mesh->getLocalToParent();
+  setLocalToParent(mesh->getLocalToParent());
   mesh->setLocalToParent(glm::translate(glm::mat4(1.0), -infos->second));
 
 #ifdef _DEBUG
@@ -93,15 +93,59 @@ SphereCollider::SphereCollider(const std::shared_ptr<TexturedMesh>& mesh)
 }
 
 // ------------------------------------------------------------------------------------------------
-CurrentTargetCollisions SphereCollider::computeCollision(CollisionManager* colMan)
+void SphereCollider::updateWorldCache()
 {
-  return colMan->computeTargetCollisions(this);
+  m_worldCenter = localToWorld()[3];
+}
+
+// ------------------------------------------------------------------------------------------------
+const glm::vec3& SphereCollider::getWorldCenter() const
+{
+  return m_worldCenter;
+}
+
+// ------------------------------------------------------------------------------------------------
+BoundingBox SphereCollider::computeWorldBounds() const
+{
+  glm::vec3 center = localToWorld()[3];
+  glm::vec3 extent = glm::vec3(m_radius);
+
+  return BoundingBox{ center - extent, center + extent };
+}
+
+// ------------------------------------------------------------------------------------------------
+std::optional<float> SphereCollider::rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const
+{
+  glm::vec3 offset = origin - glm::vec3(localToWorld()[3]);
+
+  float b = glm::dot(offset, direction);
+  float c = glm::dot(offset, offset) - m_radius * m_radius;
+
+  // Outside and pointing away
+  if (c > 0.0f && b > 0.0f)
+  {
+    return std::nullopt;
+  }
+
+  float discriminant = b * b - c;
+  if (discriminant < 0.0f)
+  {
+    return std::nullopt;
+  }
+
+  float distance = std::max(-b - std::sqrt(discriminant), 0.0f);
+  if (distance > maxDistance)
+  {
+    return std::nullopt;
+  }
+
+  return distance;
 }
 
 // ------------------------------------------------------------------------------------------------
 void SphereCollider::beforeInitialize(Renderer* renderer)
 {
-  Meshable::initializeMesh();
+  Meshable::initializeMesh(renderer);
 
   Physical::beforeInitialize(renderer);
 }
@@ -110,10 +154,11 @@ void SphereCollider::beforeInitialize(Renderer* renderer)
 void SphereCollider::beforeUpdate(Renderer* renderer, UpdateData& data)
 {
 #ifdef _DEBUG
-  Meshable::updateRenderable(renderer, data.localToWorld,
-                             20 *     // Faces on icosahedron
-                             4 * 4 *  // Divisions
-                             3 *
-                             2);      // Values
+  if (!data.render)
+  {
+    return;
+  }
+
+  Meshable::updateRenderable(renderer, data.localToWorld);
 #endif
 }
@@ -11,9 +11,16 @@ public:
   SphereCollider(const std::shared_ptr<Meshable>& target);
   SphereCollider(const std::shared_ptr<TexturedMesh>& mesh);
 
-  CurrentTargetCollisions computeCollision(CollisionManager* colMan) override;
+  void updateWorldCache() override;
+  const glm::vec3& getWorldCenter() const;
+
+  BoundingBox computeWorldBounds() const override;
+  std::optional<float> rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const override;
 
 protected:
   void beforeInitialize(Renderer* renderer) override;
   void beforeUpdate(Renderer* renderer, UpdateData& data) override;
+
+private:
+  glm::vec3 m_worldCenter;
 };
@@ -24,13 +24,16 @@ Tetrahedron::Tetrahedron(std::vector<glm::vec3> simplex)
 // ------------------------------------------------------------------------------------------------
 void Tetrahedron::beforeInitialize(Renderer* renderer)
 {
-  Meshable::initializeMesh();
+  Meshable::initializeMesh(renderer);
 }
 
 // ------------------------------------------------------------------------------------------------
 void Tetrahedron::beforeUpdate(Renderer* renderer, UpdateData& data)
 {
-  Meshable::updateRenderable(renderer, data.localToWorld,
-                             4 * // Triangles on Tetrahedron
-                             3); // Values amount
+  if (!data.render)
+  {
+    return;
+  }
+
+  Meshable::updateRenderable(renderer, data.localToWorld);
 }
@@ -13,6 +13,8 @@
 #include <sstream>
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <unordered_map>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/matrix_operation.hpp>
@@ -20,12 +22,75 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/transform.hpp>
 
+namespace
+{
+  // Import time simplification, each level clusters on a grid of half the resolution of the previous one
+  constexpr int LodCoarseLevels = 3;
+  constexpr float LodFinestGrid = 32.0f;
+
+  // Vertices sharing a grid cell are merged into their average, triangles collapsed by the merge are dropped.
+  // UVs are averaged across seams as well, only noticeable on the close levels which keep small cells.
+  size_t clusterVertices(const std::vector<TexturedMesh::VertexTextured>& vertices, const std::vector<GLuint>& indexes,
+                         float cellSize, GLuint baseVertex,
+                         std::vector<TexturedMesh::VertexTextured>& outVertices, std::vector<GLuint>& outIndexes)
+  {
+    using Vertex = TexturedMesh::VertexTextured;
+
+    const size_t firstVertex = outVertices.size();
+    const size_t firstIndex = outIndexes.size();
+
+    std::unordered_map<uint64_t, GLuint> clusters;
+    std::vector<float> weights;
+    std::vector<GLuint> remap(vertices.size());
+
+    for (size_t ii = 0; ii < vertices.size(); ++ii)
+    {
+      const Vertex& vertex = vertices[ii];
+      glm::ivec3 cell(glm::floor(vertex.position / cellSize));
+      uint64_t key = (uint64_t(cell.x & 0x1FFFFF) << 42) | (uint64_t(cell.y & 0x1FFFFF) << 21) | uint64_t(cell.z & 0x1FFFFF);
+
+      auto [it, inserted] = clusters.emplace(key, (GLuint) weights.size());
+      if (inserted)
+      {
+        outVertices.push_back(Vertex{glm::vec3(0.0), glm::vec3(0.0), glm::vec2(0.0)});
+        weights.push_back(0.0f);
+      }
+
+      Vertex& cluster = outVertices[firstVertex + it->second];
+      cluster.position += vertex.position;
+      cluster.normal += vertex.normal;
+      cluster.uv += vertex.uv;
+      weights[it->second] += 1.0f;
+
+      remap[ii] = it->second;
+    }
+
+    for (size_t ii = 0; ii < weights.size(); ++ii)
+    {
+      Vertex& cluster = outVertices[firstVertex + ii];
+      cluster.position /= weights[ii];
+      cluster.uv /= weights[ii];
+      if (glm::length(cluster.normal) > 0.0f) cluster.normal = glm::normalize(cluster.normal);
+    }
+
+    for (size_t ii = 0; ii + 2 < indexes.size(); ii += 3)
+    {
+      GLuint a = remap[indexes[ii]], b = remap[indexes[ii + 1]], c = remap[indexes[ii + 2]];
+      if (a == b || b == c || c == a) continue;
+
+      outIndexes.push_back(baseVertex + a);
+      outIndexes.push_back(baseVertex + b);
+      outIndexes.push_back(baseVertex + c);
+    }
+
+    return (outIndexes.size() - firstIndex) / 3;
+  }
+}
+
 // ------------------------------------------------------------------------------------------------
 TexturedMesh::TexturedMesh(const std::string& objFile, const std::string& texFile,
                            float scale, glm::vec3 offset, glm::vec3 rot)
-  : vertexShader(SHADER_DIR "/texture.vert", GL_VERTEX_SHADER),
-  fragmentShader(SHADER_DIR "/texture.frag", GL_FRAGMENT_SHADER),
-  shaderProgram({vertexShader, fragmentShader}),
+  : shaderProgram(nullptr),
   m_texfilePath(RESSOURCES_DIR + texFile)
 {
   // Read OBJ File
@@ -166,7 +231,33 @@ TexturedMesh::TexturedMesh(const std::string& objFile, const std::string& texFil
     }
   }
 
-  m_nFaces = faces.size();
+  m_bounds = BoundingSphere::fromVertices(m_vertices);
+
+  // Levels of detail
+  m_levels.push_back(Level{0, (GLsizei) m_indexes.size()});
+
+  float cells = LodFinestGrid;
+  for (int level = 0; level < LodCoarseLevels && m_bounds.radius > 0.0f; ++level, cells *= 0.5f)
+  {
+    const size_t vertexCount = m_coarseVertices.size();
+    const size_t indexCount = m_coarseIndexes.size();
+    const GLuint baseVertex = (GLuint) (m_vertices.size() + vertexCount);
+
+    size_t faceCount = clusterVertices(m_vertices, m_indexes, 2.0f * m_bounds.radius / cells, baseVertex,
+                                       m_coarseVertices, m_coarseIndexes);
+
+    // Not worth a level unless it saves a quarter of the previous faces, a coarser grid may
+    const size_t previousFaceCount = m_levels.back().indexCount / 3;
+    if (faceCount == 0 || 4 * faceCount > 3 * previousFaceCount)
+    {
+      m_coarseVertices.resize(vertexCount);
+      m_coarseIndexes.resize(indexCount);
+      if (faceCount == 0) break;
+      continue;
+    }
+
+    m_levels.push_back(Level{(GLsizei) (m_indexes.size() + indexCount), (GLsizei) (faceCount * 3)});
+  }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -178,6 +269,11 @@ std::vector<TexturedMesh::VertexTextured> TexturedMesh::getVertices() const
 // ------------------------------------------------------------------------------------------------
 void TexturedMesh::beforeInitialize(Renderer* renderer)
 {
+  if (renderer->isHeadless())
+  {
+    return;
+  }
+
   // Read Tex File
   {
     std::ifstream tex(m_texfilePath);
@@ -206,20 +302,34 @@ void TexturedMesh::beforeInitialize(Renderer* renderer)
     stbi_image_free(data);
   }
 
+  // Shader
+  shaderProgram = renderer->getShaderCache().getProgram(SHADER_DIR "/texture.vert", SHADER_DIR "/texture.frag");
+
+  // Every texture is bound on the first unit
+  shaderProgram->use();
+  shaderProgram->setUniform("tex", 0);
+  shaderProgram->unuse();
+
   // creation of the vertex array buffer----------------------------------------
 
-  // vbo
+  // vbo, the finest level then the coarser ones
   glGenBuffers(1, &vbo);
   glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(VertexTextured),
-               m_vertices.data(), GL_STATIC_DRAW);
+  glBufferData(GL_ARRAY_BUFFER, (m_vertices.size() + m_coarseVertices.size()) * sizeof(VertexTextured),
+               nullptr, GL_STATIC_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(VertexTextured), m_vertices.data());
+  glBufferSubData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(VertexTextured),
+                  m_coarseVertices.size() * sizeof(VertexTextured), m_coarseVertices.data());
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-  // ibo
+  // ibo, same layout
   glGenBuffers(1, &ibo);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexes.size() * sizeof(GLuint),
-               m_indexes.data(), GL_STATIC_DRAW);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, (m_indexes.size() + m_coarseIndexes.size()) * sizeof(GLuint),
+               nullptr, GL_STATIC_DRAW);
+  glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_indexes.size() * sizeof(GLuint), m_indexes.data());
+  glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, m_indexes.size() * sizeof(GLuint),
+                  m_coarseIndexes.size() * sizeof(GLuint), m_coarseIndexes.data());
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
   // vao
@@ -230,11 +340,11 @@ void TexturedMesh::beforeInitialize(Renderer* renderer)
   glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
   // map vbo to shader attributes
-  shaderProgram.setAttribute("position", 3, sizeof(VertexTextured),
+  shaderProgram->setAttribute("position", 3, sizeof(VertexTextured),
                              offsetof(VertexTextured, position));
-  shaderProgram.setAttribute("normal", 3, sizeof(VertexTextured),
+  shaderProgram->setAttribute("normal", 3, sizeof(VertexTextured),
                              offsetof(VertexTextured, normal));
-  shaderProgram.setAttribute("uv", 2, sizeof(VertexTextured),
+  shaderProgram->setAttribute("uv", 2, sizeof(VertexTextured),
                              offsetof(VertexTextured, uv));
 
   // bind the ibo
@@ -247,34 +357,22 @@ void TexturedMesh::beforeInitialize(Renderer* renderer)
 // ------------------------------------------------------------------------------------------------
 void TexturedMesh::beforeUpdate(Renderer* renderer, UpdateData& data)
 {
-  shaderProgram.use();
-
-  shaderProgram.setUniform("tex", 0);
-
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, m_texture);
-
-  // send uniforms
-  shaderProgram.setUniform("projection", renderer->getProjection());
-  shaderProgram.setUniform("view", renderer->getView() * data.localToWorld);
-
-  glCheckError(__FILE__, __LINE__);
-
-  glBindVertexArray(vao);
-
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+  if (!data.render || !shaderProgram || m_levels.empty())
+  {
+    return;
+  }
 
-  glCheckError(__FILE__, __LINE__);
-  glDrawElements(GL_TRIANGLES,     // mode
-                 m_nFaces * 3,     // count
-                 GL_UNSIGNED_INT,  // type
-                 NULL              // element array buffer offset
-  );
+  const Level& level = m_levels[renderer->getLodSelector().select(m_bounds, data.localToWorld, m_levels.size())];
 
-  glBindVertexArray(0);
-  
-  // TODO: unbind texture ?
+  RenderQueue::Packet packet{};
+  packet.program = shaderProgram.get();
+  packet.vao = vao;
+  packet.texture = m_texture;
+  packet.mode = GL_TRIANGLES;
+  packet.indexCount = level.indexCount;
+  packet.firstIndex = level.firstIndex;
+  packet.model = data.localToWorld;
+  packet.bounds = m_bounds;
 
-  shaderProgram.unuse();
+  renderer->getRenderQueue().submit(packet);
 }
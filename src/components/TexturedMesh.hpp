@@ -23,20 +23,32 @@ protected:
   void beforeUpdate(Renderer* renderer, UpdateData& data) override;
 
 private:
-  // Shader
-  Shader vertexShader;
-  Shader fragmentShader;
-  ShaderProgram shaderProgram;
+  // Shader, shared with the other meshes through the renderer cache
+  std::shared_ptr<ShaderProgram> shaderProgram;
 
   // VBO/VAO/ibo
   GLuint vao, vbo, ibo;
 
+  // Range of a level of detail in the ibo, finest first
+  struct Level
+  {
+    GLsizei firstIndex;
+    GLsizei indexCount;
+  };
+
   // Texturing
-  size_t m_nFaces;
+  std::vector<Level> m_levels;
   std::string m_texfilePath;
   unsigned int m_texture;
 
+  // Local bounds, for the culling
+  BoundingSphere m_bounds;
+
   // Infos
   std::vector<VertexTextured> m_vertices;
   std::vector<GLuint> m_indexes;
+
+  // Coarser levels, uploaded after the finest one, indexes already offset by its vertices
+  std::vector<VertexTextured> m_coarseVertices;
+  std::vector<GLuint> m_coarseIndexes;
 };
\ No newline at end of file
@@ -12,13 +12,16 @@ World::World()
 // ------------------------------------------------------------------------------------------------
 void World::beforeInitialize(Renderer* renderer)
 {
-  Meshable::initializeMesh();
+  Meshable::initializeMesh(renderer);
 }
 
 // ------------------------------------------------------------------------------------------------
 void World::beforeUpdate(Renderer* renderer, UpdateData& data)
 {
-  Meshable::updateRenderable(renderer, data.localToWorld,
-                             3 * // Edge Amount
-                             2); // Values amount
+  if (!data.render)
+  {
+    return;
+  }
+
+  Meshable::updateRenderable(renderer, data.localToWorld);
 }
@@ -0,0 +1,58 @@
+#include "HeadlessApplication.hpp"
+#include "Profiler.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// ------------------------------------------------------------------------------------------------
+// Usage: headless [scene name | all] [steps] [trace path]
+int main(int argc, const char* argv[])
+{
+  const std::string name = (argc > 1) ? argv[1] : "all";
+  const size_t steps = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1000;
+  const std::string tracePath = (argc > 3) ? argv[3] : "";
+
+  HeadlessApplication app;
+  Profiler::getInstance().setEnabled(!tracePath.empty());
+
+  std::vector<Scene*> scenes;
+  if (name == "all")
+  {
+    for (const auto& scene : app.getScenes())
+    {
+      scenes.push_back(scene.get());
+    }
+  }
+  else if (Scene* scene = app.findScene(name))
+  {
+    scenes.push_back(scene);
+  }
+  else
+  {
+    std::fprintf(stderr, "Unknown scene '%s', expected 'all' or one of:", name.c_str());
+    for (const auto& scene : app.getScenes())
+    {
+      std::fprintf(stderr, " %s", scene->getName());
+    }
+    std::fprintf(stderr, "\n");
+    return EXIT_FAILURE;
+  }
+
+  for (Scene* scene : scenes)
+  {
+    HeadlessApplication::Timing timing = app.run(scene, steps);
+
+    std::printf("%-12s %zu steps | total %9.2f ms | mean %7.3f ms/step | max %7.3f ms\n",
+                scene->getName(), timing.steps, timing.totalTime, timing.meanStepTime, timing.maxStepTime);
+  }
+
+  // Last steps of the last scene
+  if (!tracePath.empty() && !Profiler::getInstance().exportTrace(tracePath))
+  {
+    std::fprintf(stderr, "Cannot write the trace to '%s'\n", tracePath.c_str());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -7,10 +7,16 @@
 #include "components/SphereCollider.hpp"
 #include "components/Sphere.hpp"
 
+// Balls falling in a walled pit
+// - the pit is split into pitScale x pitScale cells of the default pit size
+// - balls are spread over the cells, each one filled as the default pit
 class BallpitScene final : public Scene
 {
 public:
-  BallpitScene() = default;
+  BallpitScene(size_t ballCount = 20, size_t pitScale = 1)
+    : m_ballCount(ballCount), m_pitScale(std::max<size_t>(pitScale, 1))
+  {
+  }
 
   const char* getName() const override
   {
@@ -21,10 +27,12 @@ public:
   {
     Scene::construct(renderer);
 
+    const float size = 10.0f * m_pitScale;
+
     // Ground
     {
       auto ground = std::make_shared<BoxCollider>(
-        std::make_shared<Box>(glm::vec3(10.0, 10.0, 0.5)));
+        std::make_shared<Box>(glm::vec3(size, size, 0.5)));
       auto groundRB = std::make_shared<RigidBody>(ground, 1e+6, 0.0, true, false);
       groundRB->translateBy(glm::vec3(0.0, 0.0, -5.0));
       addChild(groundRB);
@@ -33,47 +41,55 @@ public:
     // Wall1
     {
       auto wall = std::make_shared<BoxCollider>(
-        std::make_shared<Box>(glm::vec3(0.5, 10.0, 10.0)));
+        std::make_shared<Box>(glm::vec3(0.5, size, 10.0)));
       auto wallRB = std::make_shared<RigidBody>(wall, 1e+6, 0.0, true, false);
-      wallRB->translateBy(glm::vec3(-5.0, 0.0, 0.0));
+      wallRB->translateBy(glm::vec3(-size / 2.0, 0.0, 0.0));
       addChild(wallRB);
     }
 
     // Wall2
     {
       auto wall = std::make_shared<BoxCollider>(
-        std::make_shared<Box>(glm::vec3(0.5, 10.0, 10.0)));
+        std::make_shared<Box>(glm::vec3(0.5, size, 10.0)));
       auto wallRB = std::make_shared<RigidBody>(wall, 1e+6, 0.0, true, false);
-      wallRB->translateBy(glm::vec3(5.0, 0.0, 0.0));
+      wallRB->translateBy(glm::vec3(size / 2.0, 0.0, 0.0));
       addChild(wallRB);
     }
 
     // Wall3
     {
       auto wall = std::make_shared<BoxCollider>(
-        std::make_shared<Box>(glm::vec3(10.0, 0.5, 10.0)));
+        std::make_shared<Box>(glm::vec3(size, 0.5, 10.0)));
       auto wallRB = std::make_shared<RigidBody>(wall, 1e+6, 0.0, true, false);
-      wallRB->translateBy(glm::vec3(0.0, -5.0, 0.0));
+      wallRB->translateBy(glm::vec3(0.0, -size / 2.0, 0.0));
       addChild(wallRB);
     }
 
     // Wall4
     {
       auto wall = std::make_shared<BoxCollider>(
-        std::make_shared<Box>(glm::vec3(10.0, 0.5, 10.0)));
+        std::make_shared<Box>(glm::vec3(size, 0.5, 10.0)));
       auto wallRB = std::make_shared<RigidBody>(wall, 1e+6, 0.0, true, false);
-      wallRB->translateBy(glm::vec3(0.0, 5.0, 0.0));
+      wallRB->translateBy(glm::vec3(0.0, size / 2.0, 0.0));
       addChild(wallRB);
     }
 
     // Balls
     {
-      for (int ii = 0; ii < 20; ++ii)
+      const size_t cells = m_pitScale * m_pitScale;
+      for (size_t index = 0; index < m_ballCount; ++index)
       {
+        const size_t cell = index % cells;
+        const size_t ii = index / cells;
+        const glm::vec3 offset(
+          10.0 * (cell % m_pitScale) - 5.0 * (m_pitScale - 1),
+          10.0 * (cell / m_pitScale) - 5.0 * (m_pitScale - 1),
+          0.0);
+
         auto ball = std::make_shared<SphereCollider>(
           std::make_shared<Sphere>(1.0f));
         auto ballRB = std::make_shared<RigidBody>(ball, 10.0, 0.8, false, true);
-        ballRB->translateBy(glm::vec3(
+        ballRB->translateBy(offset + glm::vec3(
           (((ii + 0) * 3) % 10) / 2.0 - 2.5,
           (((ii + 1) * 3) % 10) / 2.0 - 2.5,
           ii + 3
@@ -82,4 +98,8 @@ public:
       }
     }
   }
+
+private:
+  size_t m_ballCount;
+  size_t m_pitScale;
 };